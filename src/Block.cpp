@@ -20,744 +20,308 @@
 */
 #include "Block.hpp"
 
-//Static initializer
-const bool mc__::Blk::isOpaque[] = {
-    false,  // 0 Air
-    true,   // 1 Stone
-    true,   // 2 Grass
-    true,   // 3 Dirt
-    true,   // 4 Cobble
-    true,   // 5 Wood
-    false,  // 6 Sapling
-    true,   // 7 Bedrock
-    false,  // 8 Water(*)
-    false,   // 9 WaterStill
-    true,   //10 Lava(*)
-    true,   //11 LavaStill
-    true,   //12 Sand
-    true,   //13 Gravel
-    true,   //14 GoldOre
-    true,   //15 IronOre
-    true,   //16 CoalOre
-    true,   //17 Log
-    false,  //18 Leaves
-    true,   //19 Sponge
-    false,  //20 Glass
-    true,   //21 Lapis Ore
-    true,   //22 Lapis Block
-    true,   //23 Dispenser
-    true,   //24 Sandstone
-    true,   //25 Note Block
-    false,  //26 Bed
-    false,  //27 Powered Rail
-    false,  //28 Detector Rail
-    true,   //29 ???
-    false,  //30 Web
-    false,  //31 Tall Grass
-    false,  //32 Dead Bush
-    true, true, true, true, //Reserved
-    false,  //37 Flower
-    false,  //38 Rose
-    false,  //39 BrownShroom
-    false,  //40 RedShroom
-    true,   //41 GoldBlock
-    true,   //42 IronBlock
-    true,   //43 DoubleStep
-    false,  //44 Step
-    true,   //45 Brick
-    true,   //46 TNT
-    true,   //47 Bookshelf
-    true,   //48 Mossy
-    true,   //49 Obsidian
-    false,  //50 Torch
-    false,  //51 Fire
-    false,  //52 Spawner
-    false,  //53 WoodStairs
-    false,   //54 Chest (*)
-    false,  //55 Wire (*)
-    true,   //56 DiamondOre
-    true,   //57 DiamondBlock
-    true,   //58 Workbench
-    false,  //59 Crops (*)
-    true,   //60 Soil
-    true,   //61 Furnace
-    true,   //62 LitFurnace
-    false,  //63 SignPost (*)
-    false,  //64 WoodDoor (*)
-    false,  //65 Ladder (*)
-    false,  //66 Track (*)
-    false,  //67 CobbleStairs
-    false,  //68 WallSign (*)
-    false,  //69 Lever
-    false,  //70 StonePlate
-    false,  //71 IronDoor (*)
-    false,  //72 WoodPlate
-    true,   //73 RedstoneOre
-    true,   //74 RedstoneOreLit(*)
-    false,  //75 RedstoneTorch
-    false,  //76 RedstoneTorchLit
-    false,  //77 StoneButton
-    false,  //78 SnowPlate
-    true,   //79 Ice
-    true,   //80 Snow
-    false,  //81 Cactus
-    true,   //82 Clay
-    false,  //83 Sugarcane (*)
-    true,   //84 Jukebox
-    false,  //85 Fence (*)
-    true,   //86 Pumpkin
-    true,   //87 Netherstone
-    true,   //88 91 SlowSand
-    true,   //89 Lightstone
-    false,  //90 Portal (??)
-    true,   //91 PumpkinLit
-    false,  //92 Cake
-    false,  //93 Repeater off
-    false,  //94 Repeater on
-    true,   //95 Locked chest
-    false,  //96 trapdoor
-    true,   //97 "Silverfish",
-    true,   //98 "StoneBrick,
-    true,   //99 "HugeShroomBrown",
-    true,   //100 "HugeShroomRed",
-    false,  //101 "IronBars",
-    false,   //102 "GlassPane", 
-    true,   //103 "Melon", 
-    false,   //104 "PumpkinStem", 
-    false,   //105 "MelonStem",
-    false,   //106 "Vines", 
-    false,   //107 "FenceGate", 
-    false,   //108 "StairsBrick", 
-    false,   //109 "StairsStone", 
-    true,   //110 "Mycelium Grass", 
-    false,   //111 "LilyPad",
-    true,   //112  "BrickNether", 
-    false,  //113  "FenceNether",
-    false,   //114 "StairsNether", 
-    false,   //115 "NetherWart", 
-    false,   //116 "Enchanting", 
-    false,   //117 "Brewing",
-    false,   //118 "Cauldron", 
-    false,   //119 "EndPortal", 
-    false,   //120 "EndPortalFrame", 
-    true,    //121 "EndStone", 
-    false,   //122 "DragonEgg", 
-    true,   //123 "RedLamp",
-    true,   //124 "RedLampOn",
-    true,   //125 "DoubleSlabWood", 
-    false,   //126 "SlabWood", 
-    false,   //127 "CocoaPlant", 
-    false,   //128 "StairsSand",
-    true,   //129 "EmeraldOre", 
-    false,   //130 "EndChest", 
-    false,   //131 "TripwireHook", 
-    false,   //132 "Tripwire", 
-    true,   //133 "EmeraldBlock",
-    false,   //134 "StairsSpruce", 
-    false,   //135 "StairsBirch", 
-    false,   //136 "StairsJungle", 
-    true,   //137 "Command", 
-    false,   //138 "Beacon",
-    true,   //139 "CobbleWall", 
-    false,   //140 "Flowerpot", 
-    false,   //141 "Carrots", 
-    false,   //142 "Potatoes", 
-    false,   //143 "ButtonWood", 
-    false,   //144 "Head", 
-    false
+//Properties of each block ID, packed into one byte so a lookup touches a
+// single table.  IDs past Blk::Max have no properties.
+constexpr uint8_t mc__::Blk::Properties[256] = {
+    0,                                           //  0 Air
+    opaque_FLAG|cube_FLAG,                       //  1 Stone
+    opaque_FLAG|cube_FLAG|burn_FLAG,             //  2 Grass
+    opaque_FLAG|cube_FLAG,                       //  3 Dirt
+    opaque_FLAG|cube_FLAG,                       //  4 Cobble
+    opaque_FLAG|cube_FLAG|burn_FLAG,             //  5 Wood
+    burn_FLAG,                                   //  6 Sapling
+    opaque_FLAG|cube_FLAG,                       //  7 Bedrock
+    cube_FLAG,                                   //  8 WaterFlow
+    cube_FLAG,                                   //  9 Water
+    opaque_FLAG|cube_FLAG,                       // 10 LavaFlow
+    opaque_FLAG|cube_FLAG,                       // 11 Lava
+    opaque_FLAG|cube_FLAG,                       // 12 Sand
+    opaque_FLAG|cube_FLAG,                       // 13 Gravel
+    opaque_FLAG|cube_FLAG,                       // 14 GoldOre
+    opaque_FLAG|cube_FLAG,                       // 15 IronOre
+    opaque_FLAG|cube_FLAG,                       // 16 CoalOre
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 17 Log
+    cube_FLAG|burn_FLAG,                         // 18 Leaves
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 19 Sponge
+    cube_FLAG,                                   // 20 Glass
+    opaque_FLAG|cube_FLAG,                       // 21 LapisOre
+    opaque_FLAG|cube_FLAG,                       // 22 LapisBlock
+    opaque_FLAG|cube_FLAG|logic_FLAG,            // 23 Dispenser
+    opaque_FLAG|cube_FLAG,                       // 24 Sandstone
+    opaque_FLAG|cube_FLAG|logic_FLAG|burn_FLAG,  // 25 NoteBlock
+    burn_FLAG,                                   // 26 Bed
+    logic_FLAG,                                  // 27 RailPowered
+    logic_FLAG,                                  // 28 RailDetector
+    opaque_FLAG|cube_FLAG,                       // 29 StickyPiston
+    burn_FLAG,                                   // 30 Web
+    burn_FLAG,                                   // 31 TallGrass
+    burn_FLAG,                                   // 32 DeadBush
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 33 Piston
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 34 PistonHead
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 35 Wool
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 36 PistonMoved
+    burn_FLAG,                                   // 37 Daisy
+    burn_FLAG,                                   // 38 Rose
+    0,                                           // 39 ShroomBrown
+    0,                                           // 40 ShroomRed
+    opaque_FLAG|cube_FLAG,                       // 41 GoldBlock
+    opaque_FLAG|cube_FLAG,                       // 42 IronBlock
+    opaque_FLAG|cube_FLAG,                       // 43 SlabDouble
+    0,                                           // 44 Slab
+    opaque_FLAG|cube_FLAG,                       // 45 Bricks
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 46 TNT
+    opaque_FLAG|cube_FLAG,                       // 47 Bookshelf
+    opaque_FLAG|cube_FLAG,                       // 48 MossStone
+    opaque_FLAG|cube_FLAG,                       // 49 Obsidian
+    0,                                           // 50 Torch
+    0,                                           // 51 Fire
+    0,                                           // 52 Spawner
+    burn_FLAG,                                   // 53 StairsWood
+    burn_FLAG,                                   // 54 Chest
+    logic_FLAG,                                  // 55 Wire
+    opaque_FLAG|cube_FLAG,                       // 56 DiamondOre
+    opaque_FLAG|cube_FLAG,                       // 57 DiamondBlock
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 58 Workbench
+    burn_FLAG,                                   // 59 Crops
+    opaque_FLAG,                                 // 60 Soil
+    opaque_FLAG|cube_FLAG,                       // 61 Furnace
+    opaque_FLAG|cube_FLAG,                       // 62 FurnaceOn
+    burn_FLAG,                                   // 63 Signpost
+    burn_FLAG,                                   // 64 DoorWood
+    burn_FLAG,                                   // 65 Ladder
+    0,                                           // 66 Track
+    0,                                           // 67 StairsCobble
+    burn_FLAG,                                   // 68 Wallsign
+    logic_FLAG,                                  // 69 Lever
+    logic_FLAG,                                  // 70 PlateStone
+    0,                                           // 71 DoorIron
+    logic_FLAG|burn_FLAG,                        // 72 PlateWood
+    opaque_FLAG|cube_FLAG|logic_FLAG,            // 73 RedstoneOre
+    opaque_FLAG|cube_FLAG|logic_FLAG,            // 74 RedstoneOreOn
+    logic_FLAG,                                  // 75 RedTorch
+    logic_FLAG,                                  // 76 RedTorchOn
+    logic_FLAG,                                  // 77 Button
+    0,                                           // 78 Snow
+    opaque_FLAG|cube_FLAG,                       // 79 Ice
+    opaque_FLAG|cube_FLAG,                       // 80 SnowBlock
+    burn_FLAG,                                   // 81 Cactus
+    opaque_FLAG|cube_FLAG,                       // 82 ClayBlock
+    burn_FLAG,                                   // 83 SugarCane
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 84 Jukebox
+    0,                                           // 85 Fence
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 86 Pumpkin
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 87 Netherrack
+    opaque_FLAG|cube_FLAG,                       // 88 SoulSand
+    opaque_FLAG|cube_FLAG,                       // 89 Glowstone
+    0,                                           // 90 Portal
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 91 PumpkinOn
+    burn_FLAG,                                   // 92 Cake
+    logic_FLAG,                                  // 93 Diode
+    logic_FLAG,                                  // 94 DiodeOn
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 95 ChestGlow
+    burn_FLAG,                                   // 96 TrapDoor
+    opaque_FLAG|cube_FLAG,                       // 97 Silverfish
+    opaque_FLAG|cube_FLAG,                       // 98 StoneBrick
+    opaque_FLAG|cube_FLAG|burn_FLAG,             // 99 HugeShroomBrown
+    opaque_FLAG|cube_FLAG|burn_FLAG,             //100 HugeShroomRed
+    0,                                           //101 IronBars
+    0,                                           //102 GlassPane
+    opaque_FLAG|cube_FLAG|burn_FLAG,             //103 Melon
+    burn_FLAG,                                   //104 PumpkinStem
+    burn_FLAG,                                   //105 MelonStem
+    burn_FLAG,                                   //106 Vines
+    burn_FLAG,                                   //107 FenceGate
+    0,                                           //108 StairsBrick
+    0,                                           //109 StairsStone
+    opaque_FLAG|cube_FLAG,                       //110 Mycelium
+    0,                                           //111 LilyPad
+    opaque_FLAG|cube_FLAG,                       //112 BrickNether
+    0,                                           //113 FenceNether
+    0,                                           //114 StairsNether
+    burn_FLAG,                                   //115 NetherWart
+    0,                                           //116 Enchanting
+    0,                                           //117 Brewing
+    0,                                           //118 Cauldron
+    0,                                           //119 EndPortal
+    0,                                           //120 EndPortalFrame
+    opaque_FLAG|cube_FLAG,                       //121 EndStone
+    0,                                           //122 DragonEgg
+    opaque_FLAG|cube_FLAG|logic_FLAG|burn_FLAG,  //123 RedLamp
+    opaque_FLAG|cube_FLAG|logic_FLAG|burn_FLAG,  //124 RedLampOn
+    opaque_FLAG|cube_FLAG|burn_FLAG,             //125 DoubleSlabWood
+    0,                                           //126 SlabWood
+    burn_FLAG,                                   //127 CocoaPlant
+    0,                                           //128 StairsSand
+    opaque_FLAG|cube_FLAG,                       //129 EmeraldOre
+    0,                                           //130 EndChest
+    logic_FLAG|burn_FLAG,                        //131 TripwireHook
+    logic_FLAG|burn_FLAG,                        //132 Tripwire
+    opaque_FLAG|cube_FLAG,                       //133 EmeraldBlock
+    0,                                           //134 StairsSpruce
+    0,                                           //135 StairsBirch
+    0,                                           //136 StairsJungle
+    opaque_FLAG|cube_FLAG|logic_FLAG,            //137 Command
+    cube_FLAG|logic_FLAG,                        //138 Beacon
+    opaque_FLAG|cube_FLAG,                       //139 CobbleWall
+    0,                                           //140 Flowerpot
+    burn_FLAG,                                   //141 Carrots
+    burn_FLAG,                                   //142 Potatoes
+    logic_FLAG|burn_FLAG,                        //143 ButtonWood
+    0,                                           //144 Head
+    0,                                           //145 Max
 };
 
-//Opaque cubes have their faces blocked by non-opaque cubes
-//Non-opaque cubes have their faces blocked by any cube
-
-// Some blocks will only attach to cubes, like fence, pane, bars, torch
-// (or their own type!)
-const bool mc__::Blk::isCube[] = {
-    false,  // 0 Air
-    true,   // 1 Stone
-    true,   // 2 Grass
-    true,   // 3 Dirt
-    true,   // 4 Cobble
-    true,   // 5 Wood
-    false,  // 6 Sapling
-    true,   // 7 Bedrock
-    true,   // 8 Water(*)
-    true,   // 9 WaterStill
-    true,   //10 Lava(*)
-    true,   //11 LavaStill
-    true,   //12 Sand
-    true,   //13 Gravel
-    true,   //14 GoldOre
-    true,   //15 IronOre
-    true,   //16 CoalOre
-    true,   //17 Log
-    true,   //18 Leaves
-    true,   //19 Sponge
-    true,   //20 Glass
-    true,   //21 Lapis Ore
-    true,   //22 Lapis Block
-    true,   //23 Dispenser
-    true,   //24 Sandstone
-    true,   //25 Note Block
-    false,  //26 Bed
-    false,  //27 Powered Rail
-    false,  //28 Detector Rail
-    true,   //29 ????
-    false,  //30 Web
-    false,   //31 Tall Grass
-    false,   //32 Dead Bush
-    true, true, true, true, //Cloth
-    false,  //37 Flower
-    false,  //38 Rose
-    false,  //39 BrownShroom
-    false,  //40 RedShroom
-    true,   //41 GoldBlock
-    true,   //42 IronBlock
-    true,   //43 DoubleStep
-    false,  //44 Step       (bottom is blocked)
-    true,   //45 Brick
-    true,   //46 TNT
-    true,   //47 Bookshelf
-    true,   //48 Mossy
-    true,   //49 Obsidian
-    false,  //50 Torch
-    false,  //51 Fire
-    false,  //52 Spawner
-    false,  //53 WoodStairs
-    false,   //54 Chest (*)
-    false,  //55 Wire (*)
-    true,   //56 DiamondOre
-    true,   //57 DiamondBlock
-    true,   //58 Workbench
-    false,  //59 Crops (*)
-    false,  //60 Soil   //its height is -1 pixel
-    true,   //61 Furnace
-    true,   //62 LitFurnace
-    false,  //63 SignPost (*)
-    false,  //64 WoodDoor (*)
-    false,  //65 Ladder (*)
-    false,  //66 Track (*)
-    false,  //67 CobbleStairs
-    false,  //68 WallSign (*)
-    false,  //69 Lever
-    false,  //70 StonePlate
-    false,  //71 IronDoor (*)
-    false,  //72 WoodPlate
-    true,   //73 RedstoneOre
-    true,   //74 RedstoneOreLit(*)
-    false,  //75 RedstoneTorch
-    false,  //76 RedstoneTorchLit
-    false,  //77 StoneButton
-    false,  //78 SnowPlate
-    true,   //79 Ice
-    true,   //80 Snow
-    false,  //81 Cactus (top and bottom are)
-    true,   //82 Clay
-    false,  //83 Sugarcane (*)
-    true,   //84 Jukebox
-    false,  //85 Fence (*)
-    true,   //86 Pumpkin
-    true,   //87 Netherstone
-    true,   //88 91 SlowSand
-    true,   //89 Lightstone
-    false,  //90 Portal (??)
-    true,   //91 PumpkinLit
-    false,  //92 Cake
-    false,  //93 Repeater
-    false,  //94 Repeater On
-    true,    //95 Locked Chest
-    false,   //96 Trap Door
-    true,   //97 "Silverfish",
-    true,   //98 "StoneBrick,
-    true,   //99 "HugeShroomBrown",
-    true,   //100 "HugeShroomRed",
-    false,  //101 "IronBars",
-    false,   //102 "GlassPane", 
-    true,   //103 "Melon", 
-    false,   //104 "PumpkinStem", 
-    false,   //105 "MelonStem",
-    false,   //106 "Vines", 
-    false,   //107 "FenceGate", 
-    false,   //108 "StairsBrick", 
-    false,   //109 "StairsStone", 
-    true,   //110 "Mycelium Grass", 
-    false,   //111 "LilyPad",
-    true,   //112  "BrickNether", 
-    false,  //113  "FenceNether",
-    false,   //114 "StairsNether", 
-    false,   //115 "NetherWart", 
-    false,   //116 "Enchanting", 
-    false,   //117 "Brewing",
-    false,   //118 "Cauldron", 
-    false,   //119 "EndPortal", 
-    false,   //120 "EndPortalFrame", 
-    true,    //121 "EndStone", 
-    false,   //122 "DragonEgg", 
-    true,   //123 "RedLamp",
-    true,   //124 "RedLampOn",
-    true,   //125 "DoubleSlabWood", 
-    false,   //126 "SlabWood", 
-    false,   //127 "CocoaPlant", 
-    false,   //128 "StairsSand",
-    true,   //129 "EmeraldOre", 
-    false,   //130 "EndChest", 
-    false,   //131 "TripwireHook", 
-    false,   //132 "Tripwire", 
-    true,   //133 "EmeraldBlock",
-    false,   //134 "StairsSpruce", 
-    false,   //135 "StairsBirch", 
-    false,   //136 "StairsJungle", 
-    true,   //137 "Command", 
-    true,   //138 "Beacon",
-    true,   //139 "CobbleWall", 
-    false,   //140 "Flowerpot", 
-    false,   //141 "Carrots", 
-    false,   //142 "Potatoes", 
-    false,   //143 "ButtonWood", 
-    false,   //144 "Head", 
-    false
-};
-
-//Name of placed block, mapped by ID
-const char* mc__::Blk::Name[] = {
-    "Air",
-    "Stone",
-    "Grass",
-    "Dirt",
-    "Cobblestone",
-    "Wood",
-    "Sapling",
-    "Bedrock",
-    "Water",
-    "Still water",
-    "Lava",
-    "Still lava",
-    "Sand",
-    "Gravel",
-    "Gold ore",
-    "Iron ore",
-    "Coal ore",
-    "Log",
-    "Leaves",
-    "Sponge",
-    "Glass",
-    "Lapis Ore",
-    "Lapis Block",
-    "Dispesner",
-    "Sandstone",
-    "Note Block",
-    "Bed",
-    "Powered Rail",
-    "Detector Rail",
-    "Item 29",
-    "Web",
-    "Tall Grass",
-    "Dead Bush",
-    "Item 33",
-    "Item 34",
-    "Item 35",
-    "Wool",
-    "Yellow flower",
-    "Red rose",
-    "Brown Mushroom",
-    "Red Mushroom",
-    "Gold Block",
-    "Iron Block",
-    "Double Stone Slab",
-    "Stone Slab",
-    "Brick",
-    "TNT",
-    "Bookshelf",
-    "Moss Stone",
-    "Obsidian",
-    "Torch",
-    "Fire",
-    "Monster Spawner",
-    "Wooden Stairs",
-    "Chest",
-    "Redstone Wire",
-    "Diamond Ore",
-    "Diamond Block",
-    "Workbench",
-    "Crops",
-    "Soil",
-    "Furnace",
-    "Burning Furnace",
-    "Sign Post",
-    "Wooden Door",
-    "Ladder",
-    "Minecart Tracks",
-    "Cobblestone Stairs",
-    "Wall Sign",
-    "Lever",
-    "Stone Pressure Plate",
-    "Iron Door",
-    "Wooden Pressure Plate",
-    "Redstone Ore",
-    "Glowing Redstone Ore",
-    "Redstone torch",
-    "Redstone torch (on)",
-    "Stone Button",
-    "Snow",
-    "Ice",
-    "Snow Block",
-    "Cactus",
-    "Clay",
-    "Sugarcane",
-    "Jukebox",
-    "Fence",
-    "Pumpkin",
-    "Netherrack",
-    "Soul Sand",
-    "Glowstone",
-    "Portal",
-    "Jack-O-Lantern",
-    "Cake",
-    "Repeater",
-    "Repeater Lit",
-    "Mystery Chest",
-    "Trap Door",
-    "Silverfish",
-    "StoneBrick",
-    "HugeShroomBrown",
-    "HugeShroomRed",
-    "IronBars",
-    "GlassPane", 
-    "Melon", 
-    "PumpkinStem", 
-    "MelonStem",
-    "Vines", 
-    "FenceGate", 
-    "StairsBrick", 
-    "StairsStone", 
-    "Mycelium", 
-    "LilyPad",
-    "BrickNether",
-    "FenceNether",
-    "StairsNether", 
-    "NetherWart", 
-    "Enchanting", 
-    "Brewing",
-    "Cauldron", 
-    "EndPortal", 
-    "EndPortalFrame", 
-    "EndStone", 
-    "DragonEgg", 
-    "RedLamp",
-    "RedLampOn",
-    "DoubleSlabWood", 
-    "SlabWood", 
-    "CocoaPlant", 
-    "StairsSand",
-    "EmeraldOre", 
-    "EndChest", 
-    "TripwireHook", 
-    "Tripwire", 
-    "EmeraldBlock",
-    "StairsSpruce", 
-    "StairsBirch", 
-    "StairsJungle", 
-    "Command", 
-    "Beacon",
-    "CobbleWall", 
-    "Flowerpot", 
-    "Carrots", 
-    "Potatoes", 
-    "ButtonWood", 
-    "Head", 
-    "145"
+//Name of placed block, mapped by ID (NULL past Blk::Max)
+const char* const mc__::Blk::Name[256] = {
+    "Air",                        //  0
+    "Stone",                      //  1
+    "Grass",                      //  2
+    "Dirt",                       //  3
+    "Cobblestone",                //  4
+    "Wood",                       //  5
+    "Sapling",                    //  6
+    "Bedrock",                    //  7
+    "Water",                      //  8
+    "Still water",                //  9
+    "Lava",                       // 10
+    "Still lava",                 // 11
+    "Sand",                       // 12
+    "Gravel",                     // 13
+    "Gold ore",                   // 14
+    "Iron ore",                   // 15
+    "Coal ore",                   // 16
+    "Log",                        // 17
+    "Leaves",                     // 18
+    "Sponge",                     // 19
+    "Glass",                      // 20
+    "Lapis Ore",                  // 21
+    "Lapis Block",                // 22
+    "Dispesner",                  // 23
+    "Sandstone",                  // 24
+    "Note Block",                 // 25
+    "Bed",                        // 26
+    "Powered Rail",               // 27
+    "Detector Rail",              // 28
+    "Item 29",                    // 29
+    "Web",                        // 30
+    "Tall Grass",                 // 31
+    "Dead Bush",                  // 32
+    "Item 33",                    // 33
+    "Item 34",                    // 34
+    "Item 35",                    // 35
+    "Wool",                       // 36
+    "Yellow flower",              // 37
+    "Red rose",                   // 38
+    "Brown Mushroom",             // 39
+    "Red Mushroom",               // 40
+    "Gold Block",                 // 41
+    "Iron Block",                 // 42
+    "Double Stone Slab",          // 43
+    "Stone Slab",                 // 44
+    "Brick",                      // 45
+    "TNT",                        // 46
+    "Bookshelf",                  // 47
+    "Moss Stone",                 // 48
+    "Obsidian",                   // 49
+    "Torch",                      // 50
+    "Fire",                       // 51
+    "Monster Spawner",            // 52
+    "Wooden Stairs",              // 53
+    "Chest",                      // 54
+    "Redstone Wire",              // 55
+    "Diamond Ore",                // 56
+    "Diamond Block",              // 57
+    "Workbench",                  // 58
+    "Crops",                      // 59
+    "Soil",                       // 60
+    "Furnace",                    // 61
+    "Burning Furnace",            // 62
+    "Sign Post",                  // 63
+    "Wooden Door",                // 64
+    "Ladder",                     // 65
+    "Minecart Tracks",            // 66
+    "Cobblestone Stairs",         // 67
+    "Wall Sign",                  // 68
+    "Lever",                      // 69
+    "Stone Pressure Plate",       // 70
+    "Iron Door",                  // 71
+    "Wooden Pressure Plate",      // 72
+    "Redstone Ore",               // 73
+    "Glowing Redstone Ore",       // 74
+    "Redstone torch",             // 75
+    "Redstone torch (on)",        // 76
+    "Stone Button",               // 77
+    "Snow",                       // 78
+    "Ice",                        // 79
+    "Snow Block",                 // 80
+    "Cactus",                     // 81
+    "Clay",                       // 82
+    "Sugarcane",                  // 83
+    "Jukebox",                    // 84
+    "Fence",                      // 85
+    "Pumpkin",                    // 86
+    "Netherrack",                 // 87
+    "Soul Sand",                  // 88
+    "Glowstone",                  // 89
+    "Portal",                     // 90
+    "Jack-O-Lantern",             // 91
+    "Cake",                       // 92
+    "Repeater",                   // 93
+    "Repeater Lit",               // 94
+    "Mystery Chest",              // 95
+    "Trap Door",                  // 96
+    "Silverfish",                 // 97
+    "StoneBrick",                 // 98
+    "HugeShroomBrown",            // 99
+    "HugeShroomRed",              //100
+    "IronBars",                   //101
+    "GlassPane",                  //102
+    "Melon",                      //103
+    "PumpkinStem",                //104
+    "MelonStem",                  //105
+    "Vines",                      //106
+    "FenceGate",                  //107
+    "StairsBrick",                //108
+    "StairsStone",                //109
+    "Mycelium",                   //110
+    "LilyPad",                    //111
+    "BrickNether",                //112
+    "FenceNether",                //113
+    "StairsNether",               //114
+    "NetherWart",                 //115
+    "Enchanting",                 //116
+    "Brewing",                    //117
+    "Cauldron",                   //118
+    "EndPortal",                  //119
+    "EndPortalFrame",             //120
+    "EndStone",                   //121
+    "DragonEgg",                  //122
+    "RedLamp",                    //123
+    "RedLampOn",                  //124
+    "DoubleSlabWood",             //125
+    "SlabWood",                   //126
+    "CocoaPlant",                 //127
+    "StairsSand",                 //128
+    "EmeraldOre",                 //129
+    "EndChest",                   //130
+    "TripwireHook",               //131
+    "Tripwire",                   //132
+    "EmeraldBlock",               //133
+    "StairsSpruce",               //134
+    "StairsBirch",                //135
+    "StairsJungle",               //136
+    "Command",                    //137
+    "Beacon",                     //138
+    "CobbleWall",                 //139
+    "Flowerpot",                  //140
+    "Carrots",                    //141
+    "Potatoes",                   //142
+    "ButtonWood",                 //143
+    "Head",                       //144
+    "145",                        //145
 };
 
-//Check if block is part of redstone circuit
-const bool mc__::Blk::isLogic[] = {
-    false,  // 0 Air
-    false,  // 1 Stone
-    false,  // 2 Grass
-    false,  // 3 Dirt
-    false,  // 4 Cobble
-    false,  // 5 Wood
-    false,  // 6 Sapling
-    false,  // 7 Bedrock
-    false,  // 8 Water(*)
-    false,  // 9 WaterStill
-    false,  //10 Lava(*)
-    false,  //11 LavaStill
-    false,  //12 Sand
-    false,  //13 Gravel
-    false,  //14 GoldOre
-    false,  //15 IronOre
-    false,  //16 CoalOre
-    false,  //17 Log
-    false,  //18 Leaves
-    false,  //19 Sponge
-    false,  //20 Glass
-    false,  //21 Lapis Ore
-    false,  //22 Lapis Block
-    true,   //23 Dispenser  (different from vanilla client)
-    false,  //24 Sandstone
-    true,   //25 Note Block (different from vanilla client)
-    false,  //26 Bed
-    true,   //27 Powered Rail
-    true,   //28 Detector Rail
-    false,  //29 ???
-    false,  //30 Web
-    false,  //31 Tall Grass
-    false,  //32 Dead Bush
-    false, false, false, false, //Cloth
-    false,  //37 Flower
-    false,  //38 Rose
-    false,  //39 BrownShroom
-    false,  //40 RedShroom
-    false,  //41 GoldBlock
-    false,  //42 IronBlock
-    false,  //43 DoubleStep
-    false,  //44 Step
-    false,  //45 Brick
-    false,  //46 TNT
-    false,  //47 Bookshelf
-    false,  //48 Mossy
-    false,  //49 Obsidian
-    false,  //50 Torch
-    false,  //51 Fire
-    false,  //52 Spawner
-    false,  //53 WoodStairs
-    false,  //54 Chest (*)
-    true,   //55 Wire (*)
-    false,  //56 DiamondOre
-    false,  //57 DiamondBlock
-    false,  //58 Workbench
-    false,  //59 Crops (*)
-    false,  //60 Soil
-    false,  //61 Furnace
-    false,  //62 LitFurnace
-    false,  //63 SignPost (*)
-    false,  //64 WoodDoor (*)
-    false,  //65 Ladder (*)
-    false,  //66 Track (*)
-    false,  //67 CobbleStairs
-    false,  //68 WallSign (*)
-    true,   //69 Lever
-    true,   //70 StonePlate
-    false,  //71 IronDoor (*)
-    true,   //72 WoodPlate
-    true,   //73 RedstoneOre
-    true,   //74 RedstoneOreLit(*)
-    true,   //75 RedstoneTorch
-    true,   //76 RedstoneTorchLit
-    true,   //77 StoneButton
-    false,  //78 SnowCover
-    false,  //79 Ice
-    false,  //80 Snow
-    false,  //81 Cactus
-    false,  //82 Clay
-    false,  //83 Sugarcane (*)
-    false,  //84 Jukebox
-    false,  //85 Fence (*)
-    false,  //86 Pumpkin
-    false,  //87 Netherstone
-    false,  //88 91 SlowSand
-    false,  //89 Lightstone
-    false,  //90 Portal (??)
-    false,  //91 PumpkinLit
-    false,  //92 Cake
-    true,   //93 Repeater
-    true,   //94 Repeater Off
-    false,   //95 Mystery Chest
-    false,   //96 Trap Door (maybe not?)
-    false,   //97 "Silverfish",
-    false,   //98 "StoneBrick,
-    false,   //99 "HugeShroomBrown",
-    false,   //100 "HugeShroomRed",
-    false,  //101 "IronBars",
-    false,   //102 "GlassPane", 
-    false,   //103 "Melon", 
-    false,   //104 "PumpkinStem", 
-    false,   //105 "MelonStem",
-    false,   //106 "Vines", 
-    false,   //107 "FenceGate", 
-    false,   //108 "StairsBrick", 
-    false,   //109 "StairsStone", 
-    false,   //110 "Mycelium Grass", 
-    false,   //111 "LilyPad",
-    false,   //112  "BrickNether", 
-    false,  //113  "FenceNether",
-    false,   //114 "StairsNether", 
-    false,   //115 "NetherWart", 
-    false,   //116 "Enchanting", 
-    false,   //117 "Brewing",
-    false,   //118 "Cauldron", 
-    false,   //119 "EndPortal", 
-    false,   //120 "EndPortalFrame", 
-    false,    //121 "EndStone", 
-    false,   //122 "DragonEgg", 
-    true,   //123 "RedLamp",
-    true,   //124 "RedLampOn",
-    false,   //125 "DoubleSlabWood", 
-    false,   //126 "SlabWood", 
-    false,   //127 "CocoaPlant", 
-    false,   //128 "StairsSand",
-    false,   //129 "EmeraldOre", 
-    false,   //130 "EndChest", 
-    true,   //131 "TripwireHook", 
-    true,   //132 "Tripwire", 
-    false,   //133 "EmeraldBlock",
-    false,   //134 "StairsSpruce", 
-    false,   //135 "StairsBirch", 
-    false,   //136 "StairsJungle", 
-    true,   //137 "Command", 
-    true,   //138 "Beacon",
-    false,   //139 "CobbleWall", 
-    false,   //140 "Flowerpot", 
-    false,   //141 "Carrots", 
-    false,   //142 "Potatoes", 
-    true,   //143 "ButtonWood", 
-    false,   //144 "Head", 
-    false
-    };
-
-//Check if block is flammable
-const bool mc__::Blk::doesBurn[] = {
-    false,  // 0 Air
-    false,  // 1 Stone
-    true,  // 2 Grass
-    false,  // 3 Dirt
-    false,  // 4 Cobble
-    true,  // 5 Wood
-    true,  // 6 Sapling
-    false,  // 7 Bedrock
-    false,  // 8 Water(*)
-    false,  // 9 WaterStill
-    false,  //10 Lava(*)
-    false,  //11 LavaStill
-    false,  //12 Sand
-    false,  //13 Gravel
-    false,  //14 GoldOre
-    false,  //15 IronOre
-    false,  //16 CoalOre
-    true,  //17 Log
-    true,  //18 Leaves
-    true,  //19 Sponge
-    false,  //20 Glass
-    false,  //21 Lapis Ore
-    false,  //22 Lapis Block
-    false,   //23 Dispenser  (different from vanilla client)
-    false,  //24 Sandstone
-    true,   //25 Note Block (different from vanilla client)
-    true,  //26 Bed
-    false,   //27 Powered Rail
-    false,   //28 Detector Rail
-    false,  //29 ???
-    true,  //30 Web
-    true,  //31 Tall Grass
-    true,  //32 Dead Bush
-    true, true, true, true, //Cloth
-    true,  //37 Flower
-    true,  //38 Rose
-    false,  //39 BrownShroom
-    false,  //40 RedShroom
-    false,  //41 GoldBlock
-    false,  //42 IronBlock
-    false,  //43 DoubleStep
-    false,  //44 Step
-    false,  //45 Brick
-    true,  //46 TNT
-    false,  //47 Bookshelf
-    false,  //48 Mossy
-    false,  //49 Obsidian
-    false,  //50 Torch
-    false,  //51 Fire
-    false,  //52 Spawner
-    true,  //53 WoodStairs
-    true,  //54 Chest (*)
-    false,   //55 Wire (*)
-    false,  //56 DiamondOre
-    false,  //57 DiamondBlock
-    true,  //58 Workbench
-    true,  //59 Crops (*)
-    false,  //60 Soil
-    false,  //61 Furnace
-    false,  //62 LitFurnace
-    true,  //63 SignPost (*)
-    true,  //64 WoodDoor (*)
-    true,  //65 Ladder (*)
-    false,  //66 Track (*)
-    false,  //67 CobbleStairs
-    true,  //68 WallSign (*)
-    false,   //69 Lever
-    false,   //70 StonePlate
-    false,  //71 IronDoor (*)
-    true,   //72 WoodPlate
-    false,   //73 RedstoneOre
-    false,   //74 RedstoneOreLit(*)
-    false,   //75 RedstoneTorch
-    false,   //76 RedstoneTorchLit
-    false,   //77 StoneButton
-    false,  //78 SnowCover
-    false,  //79 Ice
-    false,  //80 Snow
-    true,  //81 Cactus
-    false,  //82 Clay
-    true,  //83 Sugarcane (*)
-    true,  //84 Jukebox
-    false,  //85 Fence (*)
-    true,  //86 Pumpkin
-    true,  //87 Netherstone
-    false,  //88 91 SlowSand
-    false,  //89 Lightstone
-    false,  //90 Portal (??)
-    true,  //91 PumpkinLit
-    true,  //92 Cake
-    false,   //93 Repeater
-    false,   //94 Repeater Off
-    true,   //95 Mystery Chest
-    true,   //96 Trap Door
-    false,   //97 "Silverfish",
-    false,   //98 "StoneBrick,
-    true,   //99 "HugeShroomBrown",
-    true,   //100 "HugeShroomRed",
-    false,  //101 "IronBars",
-    false,   //102 "GlassPane", 
-    true,   //103 "Melon", 
-    true,   //104 "PumpkinStem", 
-    true,   //105 "MelonStem",
-    true,   //106 "Vines", 
-    true,   //107 "FenceGate", 
-    false,   //108 "StairsBrick", 
-    false,   //109 "StairsStone", 
-    false,   //110 "Mycelium Grass", 
-    false,   //111 "LilyPad",
-    false,   //112  "BrickNether", 
-    false,  //113  "FenceNether",
-    false,   //114 "StairsNether", 
-    true,   //115 "NetherWart", 
-    false,   //116 "Enchanting", 
-    false,   //117 "Brewing",
-    false,   //118 "Cauldron", 
-    false,   //119 "EndPortal", 
-    false,   //120 "EndPortalFrame", 
-    false,    //121 "EndStone", 
-    false,   //122 "DragonEgg", 
-    true,   //123 "RedLamp",
-    true,   //124 "RedLampOn",
-    true,   //125 "DoubleSlabWood", 
-    false,   //126 "SlabWood", 
-    true,   //127 "CocoaPlant", 
-    false,   //128 "StairsSand",
-    false,   //129 "EmeraldOre", 
-    false,   //130 "EndChest", 
-    true,   //131 "TripwireHook", 
-    true,   //132 "Tripwire", 
-    false,   //133 "EmeraldBlock",
-    false,   //134 "StairsSpruce", 
-    false,   //135 "StairsBirch", 
-    false,   //136 "StairsJungle", 
-    false,   //137 "Command", 
-    false,   //138 "Beacon",
-    false,   //139 "CobbleWall", 
-    false,   //140 "Flowerpot", 
-    true,   //141 "Carrots", 
-    true,   //142 "Potatoes", 
-    true,   //143 "ButtonWood", 
-    false,   //144 "Head", 
-    false
-};
+//Table must cover every ID it is indexed with
+static_assert(mc__::Blk::Max < 256, "Block IDs must fit in uint8_t");
+static_assert((mc__::Blk::Properties[mc__::Blk::Stone] &
+    mc__::Blk::opaque_FLAG) != 0, "Block properties out of order");
@@ -20,12 +20,16 @@
     <http://www.gnu.org/licenses/>.
 */
 
+#ifndef MC__BLOCK_H
+#define MC__BLOCK_H
+
 //Compiler specific options
 #ifdef _MSC_VER
     #include "ms_stdint.h"
 #else
     #include <stdint.h>
 #endif
+#include <cstddef>  //NULL
 
 
 namespace mc__ {
@@ -64,14 +68,35 @@ namespace mc__ {
             Max
         };
         
+        //Bits of Properties for each block ID
+        enum Property_t {
+            opaque_FLAG=0x01,   //faces of neighbors are hidden
+            cube_FLAG=0x02,     //item = !cube
+            logic_FLAG=0x04,    //used in redstone circuit
+            burn_FLAG=0x08      //can fire burn it
+                //Use cube && burn for attaching adjacent fire
+        };
+        extern const uint8_t Properties[256];
+
+        //Test one property, indexed by block ID like an array
+        typedef struct {
+            uint8_t mask;
+            bool operator[](uint8_t ID) const {
+                return ((Properties[ID] & mask) != 0);
+            };
+        } propertyTest_t;
+
         //Useful block info
-        extern const bool isOpaque[];
-        extern const bool isCube[]; //item = !cube
-        extern const char *Name[];  //block name
-        extern const bool isLogic[];//Used in redstone circuit
-        extern const bool doesBurn[];   //Can fire burn it.
-            //Use isCube && doesBurn for attaching adjacent fire
+        const propertyTest_t isOpaque = { opaque_FLAG };
+        const propertyTest_t isCube = { cube_FLAG };
+        const propertyTest_t isLogic = { logic_FLAG };
+        const propertyTest_t doesBurn = { burn_FLAG };
 
+        //Block name (NULL if unknown), and lookup that never fails
+        extern const char* const Name[256];
+        inline const char* getName(uint8_t ID) {
+            return (Name[ID] != NULL ? Name[ID] : "Unknown");
+        };
     }
 }
 
@@ -203,3 +228,4 @@ namespace mc__ {
 	122         0x7A        Dragon Egg
 */
 
+#endif
@@ -118,9 +118,6 @@ BlockDrawer::BlockDrawer( mc__::World* w, GLuint tex_array[mc__::TEX_MAX] ):
         textures[i] = tex_array[i];
     }
 
-    //Load the texture info for possible face textures
-    loadTexInfo();
-  
     //Load the block info for all known block types
     loadBlockInfo();
 
@@ -154,6 +151,15 @@ void BlockDrawer::bindTexture( tex_t index) const
 }
 
 
+//Block is a plain cube, with faces hidden by visflags
+bool BlockDrawer::isFaceCulled(uint16_t blockID) const
+{
+    drawBlock_f f = drawFunction[blockID];
+    return (f == &BlockDrawer::drawCube || f == &BlockDrawer::drawDyed ||
+        f == &BlockDrawer::drawFaceCube || f == &BlockDrawer::drawFaceCube2 ||
+        f == &BlockDrawer::drawTree);
+}
+
 //Set glColor if needed by block type and face
 void BlockDrawer::setBlockColor(uint16_t blockID, face_ID face) const
 {
@@ -2338,10 +2344,8 @@ void BlockDrawer::drawSignpost( uint8_t /*blockID*/, uint8_t meta,
     for (index = 0; index < 6; index++) {
         
         //Get texture coordinates from TextureInfo
-        TextureInfo *pti = texInfo[texture_INDEX[TEX_SIGN] + index];
-        if (pti != NULL) { pti->getCoords(
+        getTextureInfo(texture_INDEX[TEX_SIGN] + index).getCoords(
             tx0[index], tx1[index], ty0[index], ty1[index]);
-        }
     }
 
     //Cube boundaries
@@ -2525,10 +2529,8 @@ void BlockDrawer::drawSignpost( uint8_t /*blockID*/, uint8_t meta,
     for (index = 0; index < 6; index++) {
         
         //Get texture coordinates from TextureInfo
-        TextureInfo *pti = texInfo[texture_INDEX[TEX_SIGN] + 6 + index];
-        if (pti != NULL) { pti->getCoords(
+        getTextureInfo(texture_INDEX[TEX_SIGN] + 6 + index).getCoords(
             tx0[index], tx1[index], ty0[index], ty1[index]);
-        }
     }
     
     //Y values of vertices always the same
@@ -2871,10 +2873,8 @@ void BlockDrawer::drawWallSign( uint8_t /*blockID*/, uint8_t meta,
     for (index = 0; index < 6; index++) {
         
         //Get texture coordinates from TextureInfo
-        TextureInfo *pti = texInfo[texture_INDEX[TEX_SIGN] + index];
-        if (pti != NULL) { pti->getCoords(
+        getTextureInfo(texture_INDEX[TEX_SIGN] + index).getCoords(
             tx0[index], tx1[index], ty0[index], ty1[index]);
-        }
     }
 
     //Cube boundaries
@@ -3052,66 +3052,43 @@ void BlockDrawer::setBlockInfo( uint16_t index,
 
 }
 
-//Fill texture ID -> textureInfo map with default values
-bool BlockDrawer::loadTexInfo()
+//Sign board and sign post faces in sign.png:
+// left, right, bottom, top, back, front
+static constexpr TextureInfo signInfo[12] = {
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  0,  4,  4, 24),
+    TextureInfo(mc__::TEX_SIGN, 128, 64, 52,  4,  4, 24),
+    TextureInfo(mc__::TEX_SIGN, 128, 64, 52,  0, 48,  4),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  4,  0, 48,  4),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  4,  4, 48, 24),
+    TextureInfo(mc__::TEX_SIGN, 128, 64, 56,  4, 48, 24),
+
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  0, 32,  4, 28),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  8, 32,  4, 28),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  8, 28,  4,  4),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  4, 28,  4,  4),
+    TextureInfo(mc__::TEX_SIGN, 128, 64, 12, 32,  4, 28),
+    TextureInfo(mc__::TEX_SIGN, 128, 64,  4, 32,  4, 28)
+};
+
+//Texture information for texture ID, computed instead of stored
+TextureInfo BlockDrawer::getTextureInfo(uint16_t texID)
 {
-    uint16_t ID;
-
-    //Assign terrain textures 0-255
-    for (ID = texture_INDEX[TEX_TERRAIN];
-         ID < texture_INDEX[TEX_TERRAIN] + 256;
-         ID++) {
-        //Calculate texture map coordinates
-        GLfloat tx0 = GLfloat(ID & (texmap_TILES-1))/((GLfloat)texmap_TILES);
-        GLfloat ty0 = GLfloat(ID/texmap_TILES)/((GLfloat)texmap_TILES);
-        
-        //Map ID to texture information
-        texInfo[ID] = new TextureInfo(TEX_TERRAIN, tx0, tx0+tmr, ty0, ty0+tmr);
+    //Terrain textures 0-255, item textures 256-511
+    if (texID < texture_INDEX[TEX_ITEM]) {
+        return TextureInfo::tile(TEX_TERRAIN, (uint8_t)texID);
     }
-
-    //Assign item textures 256-511
-    for (ID = texture_INDEX[TEX_ITEM];
-         ID < texture_INDEX[TEX_ITEM] + 256;
-         ID++) {
-        //Calculate texture map coordinates
-        GLfloat tx0 = GLfloat(ID & (texmap_TILES-1))/((GLfloat)texmap_TILES);
-        GLfloat ty0 = GLfloat((ID&0xFF)/texmap_TILES)/((GLfloat)texmap_TILES);
-        
-        //Map ID to texture information
-        texInfo[ID] = new TextureInfo(TEX_ITEM, tx0, tx0+tmr, ty0, ty0+tmr);
+    if (texID < texture_INDEX[TEX_SIGN]) {
+        return TextureInfo::tile(TEX_ITEM, (uint8_t)texID);
     }
 
-    //
-    //Assign sign textures 512-523
-    //
-    
-    //Sign board: left, right, bottom, top, back, front
-    ID=texture_INDEX[TEX_SIGN];
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  0,  4,  4, 24);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64, 52,  4,  4, 24);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64, 52,  0, 48,  4);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  4,  0, 48,  4);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  4,  4, 48, 24);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64, 56,  4, 48, 24);
-        
-    //Sign post: left, right, bottom, top, back, front
-    ID=texture_INDEX[TEX_SIGN]+6;
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  0, 32,  4, 28);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  8, 32,  4, 28);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  8, 28,  4,  4);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  4, 28,  4,  4);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64, 12, 32,  4, 28);
-    texInfo[ID++] = new TextureInfo(TEX_SIGN, 128, 64,  4, 32,  4, 28);
-
-    //Fill the rest of IDs with sponge texture
-    for (; ID < texture_id_MAX; ID++) {
-      
-        //Associate unknown ID to the "sponge" texture information
-        texInfo[ID++] = new TextureInfo(TEX_TERRAIN, 16, 16, 0, 3, 1, 1);
+    //Sign textures 512-523
+    uint16_t index = texID - texture_INDEX[TEX_SIGN];
+    if (index < sizeof(signInfo)/sizeof(signInfo[0])) {
+        return signInfo[index];
     }
-    
 
-    return true;
+    //Unknown IDs get the "sponge" texture
+    return TextureInfo::tile(TEX_TERRAIN, Tex::Sponge);
 }
 
 //Associate the block ID to block type information
@@ -3710,9 +3687,8 @@ bool BlockDrawer::getTexInfo(uint16_t blockID, GLfloat tx_0[6], GLfloat tx_1[6],
     for (index = 0; index < 6; index++) {
         
         //Get texture coordinates from TextureInfo
-        TextureInfo *pti = texInfo[ blockInfo[blockID].textureID[index] ];
-        if (pti == NULL) { return false; }
-        pti->getCoords( tx_0[index], tx_1[index], ty_0[index], ty_1[index]);
+        getTextureInfo(blockInfo[blockID].textureID[index]).getCoords(
+            tx_0[index], tx_1[index], ty_0[index], ty_1[index]);
     }
 
     return true;
@@ -3722,28 +3698,14 @@ bool BlockDrawer::getTexInfo(uint16_t blockID, GLfloat tx_0[6], GLfloat tx_1[6],
 bool BlockDrawer::getTexCoords(uint8_t blockID, face_ID faceID,
     GLfloat& tx_0, GLfloat& tx_1, GLfloat& ty_0, GLfloat& ty_1) const
 {
-    //Return sponge texture if missing texture info
-    TextureInfo *tinfo = texInfo[blockInfo[blockID].textureID[faceID]];
-    if ( tinfo == NULL) {
-        //Return sponge texture coordinates
-        uint16_t tex = Tex::Sponge;
-        
-        //Texture map coordinates in terrain.png (0.0 - 1.0)
-        tx_0 = float(tex & (texmap_TILES-1))/((float)texmap_TILES);
-        tx_1 = tx_0 + tmr;
-        ty_0 = float(tex/texmap_TILES)/((float)texmap_TILES);
-        ty_1 = ty_0 + tmr;
-
-        //You may need to flip Y coords ty_0 and ty_1
+    //Unknown texture IDs give sponge texture
+    TextureInfo tinfo = getTextureInfo(blockInfo[blockID].textureID[faceID]);
 
-        return false;
-    }
-    
     //Texture map coordinates in terrain.png (0.0 - 1.0)
-    tx_0 = tinfo->tx_0;
-    tx_1 = tinfo->tx_1;
-    ty_1 = tinfo->ty_0; //flip Y
-    ty_0 = tinfo->ty_1; //flip Y
+    tx_0 = tinfo.tx_0;
+    tx_1 = tinfo.tx_1;
+    ty_1 = tinfo.ty_0; //flip Y
+    ty_0 = tinfo.ty_1; //flip Y
     
     return true;
 }
@@ -74,11 +74,11 @@ namespace mc__ {
     const uint16_t entity_type_MAX = 128;
     const uint16_t texture_id_MAX = 1024;
     
-    //Offsets in texInfo array for texture IDs
+    //Offsets in texture ID space for each texture file
     const uint16_t texture_INDEX[mc__::TEX_MAX] = { 0, 256, 512, 528, 544, 560, 578, 594, 610};
 
     //Texture map ratio:  tile:texmap length
-    const float tmr = 1.0f/((float)texmap_TILES);
+    constexpr float tmr = 1.0f/((float)texmap_TILES);
 
     class BlockDrawer {
         public:
@@ -91,8 +91,6 @@ namespace mc__ {
             typedef void (BlockDrawer::*drawBlock_f)(uint8_t, uint8_t,
                 GLint, GLint, GLint, uint8_t) const;
 
-            //typedef std::unordered_map< uint16_t, mc__::TextureInfo > texInfo_t;
-
             //
             // Data
             //
@@ -106,9 +104,6 @@ namespace mc__ {
             //Store information for block ID (> 256 are my own shortcuts)
             BlockInfo blockInfo[768];
             
-            //Texture information for texture ID (as found in blockInfo)
-            //texInfo_t texInfo;
-            mc__::TextureInfo *texInfo[texture_id_MAX];
             
             //Block drawing function for ID (> 256 are my own shortcuts)
             drawBlock_f drawFunction[768];
@@ -232,6 +227,9 @@ namespace mc__ {
             //Use biome color on block face
             void setBlockColor(uint16_t blockID, face_ID face) const;
             
+            //Block is a plain cube, with faces hidden by visflags
+            bool isFaceCulled(uint16_t blockID) const;
+            
             //Initialization functions
             bool loadBlockInfo();
             void setBlockInfo( uint16_t index, uint16_t A, uint16_t B, uint16_t C,
@@ -239,7 +237,8 @@ namespace mc__ {
                 drawBlock_f drawFunc = &mc__::BlockDrawer::drawCube);
                 //12 men died to bring me knowledge of class function pointers
                 
-            bool loadTexInfo( );    //Fill texture ID -> textureInfo map
+            //Texture information for texture ID (as found in blockInfo)
+            static mc__::TextureInfo getTextureInfo(uint16_t texID);
                 
         protected:
             //RGB settings for leaves, grass. TODO: use biome flag from MapChunk
@@ -83,14 +83,16 @@ Chunk::Chunk( const Chunk& ch):
             zipped_length(ch.zipped_length), zipped(NULL)
 {
     //Copy memory
-    copyZip(zipped_length, zipped);
+    if (ch.zipped != NULL) {
+        copyZip(zipped_length, ch.zipped);
+    }
     
-    if (byte_length > 0) {
+    if (byte_length > 0 && ch.byte_array != NULL) {
         byte_array = new uint8_t[byte_length];
         memcpy(byte_array, ch.byte_array, byte_length);
     }
 
-    if (array_length > 0) {
+    if (array_length > 0 && ch.block_array != NULL) {
         block_array = new Block[array_length];
         memcpy(block_array, ch.block_array, array_length*sizeof(mc__::Block));
     }
@@ -111,22 +113,26 @@ Chunk& Chunk::operator=( const Chunk& ch)
     X = ch.X; Y = ch.Y; Z = ch.Z;
     array_length = ch.array_length;
     byte_length = ch.byte_length;
-    block_array = NULL;
-    byte_array = NULL;
     isUnzipped = ch.isUnzipped;
     zipped_length = ch.zipped_length;
-    zipped = NULL;
+
+    //No leaks
+    deleteBlockArray();
+    deleteByteArray();
+    deleteZipArray();
     
     
     //Copy memory
-    copyZip(zipped_length, zipped);
+    if (ch.zipped != NULL) {
+        copyZip(zipped_length, ch.zipped);
+    }
 
-    if (byte_length > 0) {
+    if (byte_length > 0 && ch.byte_array != NULL) {
         byte_array = new uint8_t[byte_length];
         memcpy(byte_array, ch.byte_array, byte_length);
     }
 
-    if (array_length > 0) {
+    if (array_length > 0 && ch.block_array != NULL) {
         block_array = new Block[array_length];
         memcpy(block_array, ch.block_array, array_length*sizeof(mc__::Block));
     }
@@ -134,6 +140,53 @@ Chunk& Chunk::operator=( const Chunk& ch)
     return *this;
 }
 
+//Move constructor: take pointed to memory
+Chunk::Chunk( Chunk&& ch):
+            size_X(ch.size_X), size_Y(ch.size_Y), size_Z(ch.size_Z),
+            X(ch.X), Y(ch.Y), Z(ch.Z),
+            array_length(ch.array_length), byte_length(ch.byte_length),
+            block_array(ch.block_array), byte_array(ch.byte_array),
+            isUnzipped(ch.isUnzipped),
+            zipped_length(ch.zipped_length), zipped(ch.zipped)
+{
+    ch.block_array = NULL;
+    ch.byte_array = NULL;
+    ch.zipped = NULL;
+    ch.zipped_length = 0;
+    ch.isUnzipped = false;
+}
+
+//Move assignment: free my memory, take pointed to memory
+Chunk& Chunk::operator=( Chunk&& ch)
+{
+    //Don't move over myself
+    if (this == &ch) { return *this; }
+
+    deleteBlockArray();
+    deleteByteArray();
+    deleteZipArray();
+
+    size_X = ch.size_X;
+    size_Y = ch.size_Y;
+    size_Z = ch.size_Z;
+    X = ch.X; Y = ch.Y; Z = ch.Z;
+    array_length = ch.array_length;
+    byte_length = ch.byte_length;
+    block_array = ch.block_array;
+    byte_array = ch.byte_array;
+    isUnzipped = ch.isUnzipped;
+    zipped_length = ch.zipped_length;
+    zipped = ch.zipped;
+
+    ch.block_array = NULL;
+    ch.byte_array = NULL;
+    ch.zipped = NULL;
+    ch.zipped_length = 0;
+    ch.isUnzipped = false;
+
+    return *this;
+}
+
 //Copy block_array to byte_array
 void Chunk::packBlocks()
 {
@@ -318,6 +371,18 @@ void Chunk::copyZip(uint32_t size, const uint8_t *data)
     }
 }
 
+//Take compressed data allocated with new[]
+void Chunk::adoptZip(uint32_t size, uint8_t *data)
+{
+    if (data == zipped) {
+        zipped_length = size;
+        return;
+    }
+    deleteZipArray();
+    zipped_length = size;
+    zipped = data;
+}
+
 //Compress the packed byte_array to *compressed, set compressed_length
 bool Chunk::zip()
 {
@@ -328,9 +393,11 @@ bool Chunk::zip()
     //Re-allocate zipped bytes
     allocZip(zipped_length);
 
-    //Use Zlib to compress the byte_array
-    int result = compress2( zipped, (uLongf*)&zipped_length,
+    //Use Zlib to compress the byte_array (uLongf may be wider than 32 bits)
+    uLongf length = zipped_length;
+    int result = compress2( zipped, &length,
         (const Bytef*)byte_array, (uLong)byte_length, Z_BEST_SPEED);
+    zipped_length = length;
 
     //Problem?
     if (result != Z_OK)
@@ -352,8 +419,10 @@ bool Chunk::unzip(bool free_zip)
     allocByteArray();
 
     //Use Zlib to uncompress the zipped data to byte_array
-    int result = uncompress( byte_array, (uLongf*)&byte_length,
+    uLongf length = byte_length;
+    int result = uncompress( byte_array, &length,
         zipped, zipped_length );
+    byte_length = length;
     
     //Problem?
     if (result != Z_OK)
@@ -58,6 +58,10 @@ namespace mc__ {
             Chunk( const Chunk& ch);
             Chunk& operator=( const Chunk& ch);
 
+            //Move constructor: take pointed to memory, ch is left empty
+            Chunk( Chunk&& ch);
+            Chunk& operator=( Chunk&& ch);
+
             //Set world block coordinates
             void setCoord(int32_t x, int8_t y, int32_t z);
             
@@ -83,6 +87,9 @@ namespace mc__ {
 
             //Copy compressed data to chunk
             void copyZip( uint32_t length, const uint8_t *data);
+
+            //Take compressed data allocated with new[], chunk deletes it
+            void adoptZip( uint32_t length, uint8_t *data);
             
             //Compress the packed byte_array to *compressed
             bool zip();
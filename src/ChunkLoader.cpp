@@ -0,0 +1,323 @@
+/*
+  mc__::ChunkLoader
+    Load map chunks from region files on a worker thread, nearest first
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "ChunkLoader.hpp"
+using mc__::ChunkLoader;
+using mc__::Chunk;
+using mc__::Region;
+
+//STL
+#include <algorithm>    //push_heap, pop_heap, make_heap
+#include <chrono>
+#include <cstring>      //memset
+#include <iostream>
+#include <sstream>
+using std::cerr;
+using std::endl;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+//Static const definitions
+const uint8_t ChunkLoader::latency_BUCKETS;
+
+//Seconds on steady clock
+static double loaderTime()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Constructor
+ChunkLoader::ChunkLoader(): center_X(0), center_Z(0), stopping(false)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+//Stop worker, delete chunks not collected
+ChunkLoader::~ChunkLoader()
+{
+    stop();
+
+    vector<Chunk*>::iterator iter;
+    for (iter = loaded.begin(); iter != loaded.end(); iter++) {
+        delete *iter;
+    }
+    loaded.clear();
+}
+
+//Start worker thread reading region files in path
+bool ChunkLoader::start(const string& path)
+{
+    if (isRunning()) {
+        return false;
+    }
+    regionPath = path;
+    stopping = false;
+    worker = std::thread(&ChunkLoader::run, this);
+    return true;
+}
+
+//Stop worker thread, keep requests
+void ChunkLoader::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+    closeRegions();
+}
+
+//Request map chunk containing block X,Z
+void ChunkLoader::request(int32_t X, int32_t Z)
+{
+    uint64_t key = getKey(X & 0xFFFFFFF0, Z & 0xFFFFFFF0);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!pending.insert(requestMap_t::value_type(key, loaderTime())).second)
+        {
+            return;
+        }
+        heap.push_back(key);
+        std::push_heap(heap.begin(), heap.end(),
+            [this](uint64_t a, uint64_t b) { return farther(a, b); });
+    }
+    wake.notify_one();
+}
+
+//Forget request if not started
+bool ChunkLoader::cancel(int32_t X, int32_t Z)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    //Heap entry is skipped when popped
+    if (pending.erase(getKey(X & 0xFFFFFFF0, Z & 0xFFFFFFF0)) == 0) {
+        return false;
+    }
+    stats.cancelled++;
+    return true;
+}
+
+//Forget requests farther than radius blocks from X,Z
+size_t ChunkLoader::cancelOutside(double X, double Z, double radius)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t result=0;
+
+    requestMap_t::iterator iter = pending.begin();
+    while (iter != pending.end()) {
+        double dx = getX(iter->first) + 8 - X;
+        double dz = getZ(iter->first) + 8 - Z;
+        if (dx*dx + dz*dz > radius*radius) {
+            iter = pending.erase(iter);
+            result++;
+        } else {
+            iter++;
+        }
+    }
+    stats.cancelled += result;
+
+    //Drop cancelled keys from heap now, it may be long
+    if (result > 0) {
+        size_t count=0;
+        for (size_t i = 0; i < heap.size(); i++) {
+            if (pending.count(heap[i]) > 0) {
+                heap[count++] = heap[i];
+            }
+        }
+        heap.resize(count);
+        std::make_heap(heap.begin(), heap.end(),
+            [this](uint64_t a, uint64_t b) { return farther(a, b); });
+    }
+
+    return result;
+}
+
+//Load requests nearest to X,Z first
+void ChunkLoader::setCenter(double X, double Z)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    center_X = X;
+    center_Z = Z;
+    std::make_heap(heap.begin(), heap.end(),
+        [this](uint64_t a, uint64_t b) { return farther(a, b); });
+}
+
+//Move up to max loaded chunks to out
+size_t ChunkLoader::collect(vector<Chunk*>& out, size_t max)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t count = (loaded.size() < max ? loaded.size() : max);
+    out.insert(out.end(), loaded.begin(), loaded.begin() + count);
+    loaded.erase(loaded.begin(), loaded.begin() + count);
+    return count;
+}
+
+//Requests waiting
+size_t ChunkLoader::depth() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return pending.size();
+}
+
+//Loaded chunks not collected
+size_t ChunkLoader::ready() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return loaded.size();
+}
+
+//Request counters and latency histogram
+ChunkLoader::loaderStats_t ChunkLoader::getStats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
+
+//Worker thread loop: load nearest request until stopped
+void ChunkLoader::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (!stopping) {
+        //Wait for request
+        if (heap.empty()) {
+            wake.wait(guard);
+            continue;
+        }
+
+        //Take nearest request, skip it if cancelled
+        std::pop_heap(heap.begin(), heap.end(),
+            [this](uint64_t a, uint64_t b) { return farther(a, b); });
+        uint64_t key = heap.back();
+        heap.pop_back();
+        requestMap_t::iterator iter = pending.find(key);
+        if (iter == pending.end()) {
+            continue;
+        }
+        double requested = iter->second;
+        pending.erase(iter);
+
+        //Read and uncompress without holding the lock
+        guard.unlock();
+        Chunk* chunk;
+        {
+            std::lock_guard<std::mutex> files(regionLock);
+            chunk = load(getX(key), getZ(key));
+        }
+        guard.lock();
+
+        if (chunk != NULL) {
+            loaded.push_back(chunk);
+            stats.loaded++;
+            addLatency(loaderTime() - requested);
+        } else {
+            stats.missing++;
+        }
+    }
+}
+
+//Load chunk at X,Z from region file
+Chunk* ChunkLoader::load(int32_t X, int32_t Z)
+{
+    //Map region file once
+    uint64_t key = getKey(X >> Region::region_SHIFT, Z >> Region::region_SHIFT);
+    Region* region;
+    std::unordered_map< uint64_t, Region* >::const_iterator iter =
+        regions.find(key);
+    if (iter != regions.end()) {
+        region = iter->second;
+    } else {
+        stringstream filename;
+        filename << regionPath << "/region_" << (X >> Region::region_SHIFT)
+            << "_" << (Z >> Region::region_SHIFT) << ".mcr";
+        region = new Region();
+        if (!region->open(filename.str())) {
+            delete region;
+            region = NULL;
+        }
+        regions.insert(std::make_pair(key, region));
+    }
+
+    //Copy and uncompress chunk data
+    const uint8_t* data;
+    uint32_t length;
+    if (region == NULL || !region->getChunk(X, Z, data, length)) {
+        return NULL;
+    }
+    Chunk* chunk = new Chunk(15, 127, 15, X, 0, Z, false);
+    chunk->copyZip(length, data);
+    if (!chunk->unzip(true)) {
+        cerr << "Error loading chunk from region @ X=" << X
+            << " Z=" << Z << endl;
+        delete chunk;
+        chunk = NULL;
+    }
+    return chunk;
+}
+
+//Unmap region files until resumeRegions
+void ChunkLoader::pauseRegions()
+{
+    regionLock.lock();
+    closeRegions();
+}
+
+//Let the worker map region files again
+void ChunkLoader::resumeRegions()
+{
+    regionLock.unlock();
+}
+
+//Unmap all region files
+void ChunkLoader::closeRegions()
+{
+    std::unordered_map< uint64_t, Region* >::iterator iter;
+    for (iter = regions.begin(); iter != regions.end(); iter++) {
+        delete iter->second;
+    }
+    regions.clear();
+}
+
+//Heap order: farther from center is "less"
+bool ChunkLoader::farther(uint64_t a, uint64_t b) const
+{
+    double ax = getX(a) + 8 - center_X, az = getZ(a) + 8 - center_Z;
+    double bx = getX(b) + 8 - center_X, bz = getZ(b) + 8 - center_Z;
+    return (ax*ax + az*az > bx*bx + bz*bz);
+}
+
+//Count request latency in histogram
+void ChunkLoader::addLatency(double seconds)
+{
+    double ms = seconds*1000;
+    uint8_t bucket = 0;
+    while (ms >= 1 && bucket < latency_BUCKETS - 1) {
+        ms /= 2;
+        bucket++;
+    }
+    stats.latency[bucket]++;
+}
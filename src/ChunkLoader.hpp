@@ -0,0 +1,149 @@
+/*
+  mc__::ChunkLoader
+    Load map chunks from region files on a worker thread, nearest first
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__CHUNKLOADER_H
+#define MC__CHUNKLOADER_H
+
+//mc--
+#include "Chunk.hpp"
+#include "Region.hpp"
+
+//STL
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+namespace mc__ {
+
+    //Requests are kept by map chunk, and the nearest one to the center is
+    // loaded next.  Loaded chunks wait in a staging list for collect.
+    class ChunkLoader {
+        public:
+            //Latency histogram bucket i counts requests finished in
+            // [2^(i-1), 2^i) milliseconds (bucket 0 is under 1 ms)
+            static const uint8_t latency_BUCKETS = 16;
+
+            //Request counters
+            typedef struct {
+                size_t loaded;      //found in region file
+                size_t missing;     //not in region file
+                size_t cancelled;   //removed before loading
+                uint32_t latency[latency_BUCKETS];  //request to loaded
+            } loaderStats_t;
+
+            //Constructor, worker is not started
+            ChunkLoader();
+
+            //Stop worker, delete chunks not collected
+            ~ChunkLoader();
+
+            //Start worker thread reading region files in path
+            bool start(const std::string& path);
+            void stop();
+            bool isRunning() const { return worker.joinable(); };
+
+            //Request map chunk containing block X,Z (ignored if pending)
+            void request(int32_t X, int32_t Z);
+
+            //Forget request if not started (false if not pending)
+            bool cancel(int32_t X, int32_t Z);
+
+            //Forget requests farther than radius blocks from X,Z
+            //  Returns number of requests cancelled.
+            size_t cancelOutside(double X, double Z, double radius);
+
+            //Load requests nearest to X,Z (blocks) first
+            void setCenter(double X, double Z);
+
+            //Move up to max loaded chunks to out (caller deletes them)
+            //  Returns number of chunks moved.
+            size_t collect(std::vector<mc__::Chunk*>& out, size_t max);
+
+            //Unmap region files and keep the worker from mapping them
+            // again until resumeRegions, so they can be replaced on disk.
+            //  Waits for a chunk being read to finish.
+            void pauseRegions();
+            void resumeRegions();
+
+            //Metrics: requests waiting, loaded chunks not collected
+            size_t depth() const;
+            size_t ready() const;
+            loaderStats_t getStats() const;
+
+        protected:
+            //Pending request: time requested (seconds)
+            typedef std::unordered_map< uint64_t, double > requestMap_t;
+            requestMap_t pending;
+
+            //Heap of requested keys, nearest to center on top.  Keys no
+            // longer pending are skipped when popped.
+            std::vector<uint64_t> heap;
+            double center_X, center_Z;
+
+            //Loaded chunks waiting for collect, and counters
+            std::vector<mc__::Chunk*> loaded;
+            loaderStats_t stats;
+
+            //Worker thread and its region files
+            std::string regionPath;
+            std::unordered_map< uint64_t, mc__::Region* > regions;
+            std::thread worker;
+            bool stopping;
+
+            //Guards everything above except the region files
+            mutable std::mutex lock;
+            std::condition_variable wake;
+
+            //Guards the region files, held by the worker while it reads
+            // and by pauseRegions until resumeRegions
+            std::mutex regionLock;
+
+            //Worker thread loop
+            void run();
+
+            //Load chunk at X,Z from region file (NULL if not found)
+            mc__::Chunk* load(int32_t X, int32_t Z);
+            void closeRegions();
+
+            //Key <-> block coordinates of map chunk
+            static uint64_t getKey(int32_t X, int32_t Z) {
+                return ((uint64_t)(uint32_t)X << 32) | (uint32_t)Z;
+            };
+            static int32_t getX(uint64_t key) { return (int32_t)(key >> 32); };
+            static int32_t getZ(uint64_t key) { return (int32_t)key; };
+
+            //Heap order: farther key is "less", so nearest is on top
+            bool farther(uint64_t a, uint64_t b) const;
+
+            //Count request latency in histogram
+            void addLatency(double seconds);
+
+        private:
+            //Thread can't be copied
+            ChunkLoader( const ChunkLoader& c);
+            ChunkLoader& operator=( const ChunkLoader& c);
+    };
+}
+
+#endif
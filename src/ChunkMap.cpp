@@ -0,0 +1,173 @@
+/*
+  mc__::ChunkMap
+    Map of X|Z key to MapChunk*, found without locking from any thread
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "ChunkMap.hpp"
+using mc__::ChunkMap;
+using mc__::MapChunk;
+
+//Static const definitions
+const uint64_t ChunkMap::key_EMPTY;
+
+//Constructor
+ChunkMap::ChunkMap(mc__::Epoch& e): count(0), epoch(e)
+{
+    table.store(newTable(64));
+}
+
+//Free table
+ChunkMap::~ChunkMap()
+{
+    deleteTable(table.load());
+}
+
+//Map chunk with key
+MapChunk* ChunkMap::find(uint64_t key) const
+{
+    const table_t *t = table.load();
+    for (size_t i = hash(key) & t->mask; ; i = (i + 1) & t->mask) {
+        uint64_t k = t->keys[i].load();
+        if (k == key) {
+            return t->values[i].load();
+        }
+        if (k == key_EMPTY) {
+            return NULL;
+        }
+    }
+}
+
+//Add or replace map chunk with key
+void ChunkMap::insert(uint64_t key, MapChunk* mapchunk)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+
+    //Keep at most 3/4 of slots used
+    table_t *t = table.load();
+    if ((t->used + 1)*4 > (t->mask + 1)*3) {
+        rebuild();
+        t = table.load();
+    }
+
+    for (size_t i = hash(key) & t->mask; ; i = (i + 1) & t->mask) {
+        uint64_t k = t->keys[i].load();
+        if (k == key) {
+            if (t->values[i].exchange(mapchunk) == NULL) {
+                count++;
+            }
+            return;
+        }
+        if (k == key_EMPTY) {
+            //Value first, so readers never see the key without it
+            t->values[i].store(mapchunk);
+            t->keys[i].store(key);
+            t->used++;
+            count++;
+            return;
+        }
+    }
+}
+
+//Remove key, return its map chunk
+MapChunk* ChunkMap::erase(uint64_t key)
+{
+    std::lock_guard<std::mutex> guard(writeLock);
+
+    table_t *t = table.load();
+    for (size_t i = hash(key) & t->mask; ; i = (i + 1) & t->mask) {
+        uint64_t k = t->keys[i].load();
+        if (k == key) {
+            MapChunk *result = t->values[i].exchange(NULL);
+            if (result != NULL) {
+                count--;
+            }
+            return result;
+        }
+        if (k == key_EMPTY) {
+            return NULL;
+        }
+    }
+}
+
+//Allocate empty table
+ChunkMap::table_t* ChunkMap::newTable(size_t size)
+{
+    table_t *t = new table_t;
+    t->mask = size - 1;
+    t->used = 0;
+    t->keys = new std::atomic<uint64_t>[size];
+    t->values = new std::atomic<MapChunk*>[size];
+    for (size_t i = 0; i < size; i++) {
+        t->keys[i].store(key_EMPTY, std::memory_order_relaxed);
+        t->values[i].store(NULL, std::memory_order_relaxed);
+    }
+    return t;
+}
+
+//Free table
+void ChunkMap::deleteTable(table_t* t)
+{
+    delete[] t->keys;
+    delete[] t->values;
+    delete t;
+}
+
+//Slot to start probing for key (splitmix64 finalizer)
+size_t ChunkMap::hash(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return (size_t)key;
+}
+
+//Copy live entries to a new table, retire the old one
+void ChunkMap::rebuild()
+{
+    table_t *old = table.load();
+
+    //Grow only if live entries use more than half the slots
+    size_t size = old->mask + 1;
+    if (count.load()*2 > size) {
+        size *= 2;
+    }
+
+    table_t *t = newTable(size);
+    for (size_t i = 0; i <= old->mask; i++) {
+        MapChunk *mapchunk = old->values[i].load();
+        if (mapchunk == NULL) {
+            continue;
+        }
+        uint64_t key = old->keys[i].load();
+        size_t j = hash(key) & t->mask;
+        while (t->keys[j].load(std::memory_order_relaxed) != key_EMPTY) {
+            j = (j + 1) & t->mask;
+        }
+        t->keys[j].store(key, std::memory_order_relaxed);
+        t->values[j].store(mapchunk, std::memory_order_relaxed);
+        t->used++;
+    }
+
+    //Readers still probing the old table finish before it is deleted
+    table.store(t);
+    epoch.retire([old]() { deleteTable(old); });
+}
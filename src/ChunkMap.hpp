@@ -0,0 +1,95 @@
+/*
+  mc__::ChunkMap
+    Map of X|Z key to MapChunk*, found without locking from any thread
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__CHUNKMAP_H
+#define MC__CHUNKMAP_H
+
+//mc--
+#include "Epoch.hpp"
+
+//STL
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace mc__ {
+    class MapChunk;
+
+    //Open addressing hash table with linear probing.  find does not lock;
+    // insert and erase are serialized by a mutex.  Erased entries keep
+    // their key with a NULL value until the table is rebuilt.  A rebuilt
+    // table replaces the old one, which is retired to the epoch.
+    class ChunkMap {
+        public:
+            //Key that no map chunk has (keys are multiples of 16)
+            static const uint64_t key_EMPTY = ~(uint64_t)0;
+
+            //Constructor, old tables are retired to epoch
+            ChunkMap(mc__::Epoch& e);
+
+            //Free table (map chunks are not deleted)
+            ~ChunkMap();
+
+            //Map chunk with key (NULL if none).  Readers on other threads
+            // must hold an Epoch::Guard while using the table and result.
+            mc__::MapChunk* find(uint64_t key) const;
+
+            //Add or replace map chunk with key
+            void insert(uint64_t key, mc__::MapChunk* mapchunk);
+
+            //Remove key, return its map chunk (NULL if none)
+            mc__::MapChunk* erase(uint64_t key);
+
+            //Map chunks in map
+            size_t size() const { return count.load(); };
+
+        protected:
+            //Table of 2^n slots
+            typedef struct {
+                size_t mask;
+                size_t used;        //slots with a key (erased too)
+                std::atomic<uint64_t> *keys;
+                std::atomic<mc__::MapChunk*> *values;
+            } table_t;
+
+            std::atomic<table_t*> table;
+            std::atomic<size_t> count;
+            mc__::Epoch& epoch;
+            std::mutex writeLock;
+
+            //Allocate empty table of size slots (power of 2)
+            static table_t* newTable(size_t size);
+            static void deleteTable(table_t* t);
+
+            //Slot to start probing for key
+            static size_t hash(uint64_t key);
+
+            //Copy live entries to table twice as big (or same size)
+            void rebuild();
+
+        private:
+            //Table can't be copied
+            ChunkMap( const ChunkMap& m);
+            ChunkMap& operator=( const ChunkMap& m);
+    };
+}
+
+#endif
@@ -0,0 +1,486 @@
+/*
+  mc__::EntityStore
+    Positions and directions of all entities, stored by slot in arrays
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "EntityStore.hpp"
+using mc__::EntityStore;
+using mc__::Entity;
+
+//C
+#include <cmath>    //floor
+
+//STL
+#include <algorithm>
+#include <chrono>
+#include <limits>
+using std::chrono::steady_clock;
+using std::chrono::duration;
+
+//Static constants
+const uint32_t EntityStore::npos;
+const uint8_t EntityStore::snap_MAX;
+const uint8_t EntityStore::cell_SHIFT;
+
+//Updates closer than this to the newest snapshot are from the same batch
+// (one network tick stamped once), far less than a tick of jitter
+static const double snap_BATCH = 0.002;
+
+//Constructor
+EntityStore::EntityStore(): interpDelay(0.1), extrapLimit(0.25),
+    snapInterval(0.05)
+{
+}
+
+//Add entity, or update it if EID is known.  Returns slot.
+uint32_t EntityStore::add(uint32_t eid, kind_t k, uint8_t type_id,
+    Entity* obj, int32_t x, int32_t y, int32_t z, float YAW, float PITCH)
+{
+    uint32_t slot = find(eid);
+
+    if (slot == npos) {
+        //Reuse a free slot, or add one to the end of every array
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = EID.size();
+            EID.push_back(0); kind.push_back(KIND_NONE); typeID.push_back(0);
+            X.push_back(0); Y.push_back(0); Z.push_back(0);
+            abs_X.push_back(0); abs_Y.push_back(0); abs_Z.push_back(0);
+            dX.push_back(0); dY.push_back(0); dZ.push_back(0);
+            yaw.push_back(0); pitch.push_back(0);
+            object.push_back(NULL);
+            draw_X.push_back(0); draw_Y.push_back(0); draw_Z.push_back(0);
+            draw_yaw.push_back(0);
+            snapTime.resize(snapTime.size() + snap_MAX, 0);
+            snapX.resize(snapX.size() + snap_MAX, 0);
+            snapY.resize(snapY.size() + snap_MAX, 0);
+            snapZ.resize(snapZ.size() + snap_MAX, 0);
+            snapYaw.resize(snapYaw.size() + snap_MAX, 0);
+            snapNewest.push_back(0); snapCount.push_back(0);
+            cellKey.push_back(0); cellPos.push_back(npos);
+            synced.push_back(objectState_t());
+        }
+        slotIndex[eid] = slot;
+    }
+
+    //Set entity state
+    EID[slot] = eid;
+    kind[slot] = k;
+    typeID[slot] = type_id;
+    X[slot] = x; Y[slot] = y; Z[slot] = z;
+    abs_X[slot] = x/32.0; abs_Y[slot] = y/32.0; abs_Z[slot] = z/32.0;
+    dX[slot] = 0; dY[slot] = 0; dZ[slot] = 0;
+    yaw[slot] = YAW; pitch[slot] = PITCH;
+    object[slot] = obj;
+
+    //Earlier writes to the object are replaced by the store on next sync
+    setSynced(slot);
+
+    //Start drawing at new position, without interpolating from old one
+    draw_X[slot] = x/32.0f; draw_Y[slot] = y/32.0f; draw_Z[slot] = z/32.0f;
+    draw_yaw[slot] = YAW;
+    snapCount[slot] = 0;
+    snapshot(slot, now());
+    updateCell(slot);
+
+    return slot;
+}
+
+//Forget entity and recycle its slot (false if not found)
+bool EntityStore::remove(uint32_t eid)
+{
+    slotMap_t::iterator iter = slotIndex.find(eid);
+    if (iter == slotIndex.end()) {
+        return false;
+    }
+
+    uint32_t slot = iter->second;
+    slotIndex.erase(iter);
+    removeCell(slot);
+
+    //Mark slot free
+    kind[slot] = KIND_NONE;
+    object[slot] = NULL;
+    freeSlots.push_back(slot);
+
+    return true;
+}
+
+//Apply moves of known EIDs (unknown EIDs are skipped)
+size_t EntityStore::applyMoves(const move_t* moves, size_t count,
+    std::vector<size_t>* unknown, double seconds)
+{
+    if (moved.size() < EID.size()) {
+        moved.resize(EID.size(), 0);
+    }
+    
+    //Add fixed point deltas, remember each slot moved once
+    size_t applied = 0;
+    movedSlots.clear();
+    for (size_t i = 0; i < count; i++) {
+        const move_t& m = moves[i];
+        uint32_t slot = find(m.eid);
+        if (slot == npos) {
+            if (unknown != NULL) {
+                unknown->push_back(i);
+            }
+            continue;
+        }
+        X[slot] += m.dX;
+        Y[slot] += m.dY;
+        Z[slot] += m.dZ;
+        yaw[slot] += m.dYaw*(360.0f/256.0f);
+        pitch[slot] += m.dPitch*(360.0f/256.0f);
+        applied++;
+        if (!moved[slot]) {
+            moved[slot] = 1;
+            movedSlots.push_back(slot);
+        }
+    }
+    
+    //Convert each moved slot to doubles once
+    std::vector<uint32_t>::const_iterator iter;
+    for (iter = movedSlots.begin(); iter != movedSlots.end(); iter++) {
+        uint32_t slot = *iter;
+        abs_X[slot] = X[slot]*(1/32.0);
+        abs_Y[slot] = Y[slot]*(1/32.0);
+        abs_Z[slot] = Z[slot]*(1/32.0);
+        moved[slot] = 0;
+        snapshot(slot, seconds);
+        updateCell(slot);
+    }
+    
+    return applied;
+}
+
+//Forget all entities
+void EntityStore::clear()
+{
+    slotIndex.clear();
+    freeSlots.clear();
+    EID.clear(); kind.clear(); typeID.clear();
+    X.clear(); Y.clear(); Z.clear();
+    abs_X.clear(); abs_Y.clear(); abs_Z.clear();
+    dX.clear(); dY.clear(); dZ.clear();
+    yaw.clear(); pitch.clear();
+    object.clear();
+    draw_X.clear(); draw_Y.clear(); draw_Z.clear(); draw_yaw.clear();
+    snapTime.clear(); snapX.clear(); snapY.clear(); snapZ.clear();
+    snapYaw.clear(); snapNewest.clear(); snapCount.clear();
+    cells.clear(); cellKey.clear(); cellPos.clear();
+    synced.clear();
+}
+
+//Take one axis written to the object since the last sync (false if not
+// written).  Absolute position wins over 1/32 block position.
+static bool takeAxis(int32_t& x, double& abs_x, double objectAbs,
+    int32_t objectX, double syncedAbs, int32_t syncedX)
+{
+    if (objectAbs != syncedAbs) {
+        abs_x = objectAbs;
+        x = (int32_t)floor(objectAbs*32);
+        return true;
+    }
+    if (objectX != syncedX) {
+        x = objectX;
+        abs_x = objectX*(1/32.0);
+        return true;
+    }
+    return false;
+}
+
+//Take writes to the object into the store, then copy the store to it
+void EntityStore::sync(uint32_t slot)
+{
+    Entity* e = object[slot];
+    if (e == NULL) {
+        return;
+    }
+    const objectState_t& s = synced[slot];
+
+    bool moved = false;
+    moved |= takeAxis(X[slot], abs_X[slot], e->abs_X, e->X, s.abs_X, s.X);
+    moved |= takeAxis(Y[slot], abs_Y[slot], e->abs_Y, e->Y, s.abs_Y, s.Y);
+    moved |= takeAxis(Z[slot], abs_Z[slot], e->abs_Z, e->Z, s.abs_Z, s.Z);
+    bool turned = (e->yaw != s.yaw || e->pitch != s.pitch);
+    if (turned) {
+        yaw[slot] = e->yaw;
+        pitch[slot] = e->pitch;
+    }
+
+    //Jump to the written position, without interpolating from the old one
+    if (moved || turned) {
+        draw_X[slot] = abs_X[slot];
+        draw_Y[slot] = abs_Y[slot];
+        draw_Z[slot] = abs_Z[slot];
+        draw_yaw[slot] = yaw[slot];
+        snapCount[slot] = 0;
+        snapshot(slot, now());
+        updateCell(slot);
+    }
+
+    e->X = X[slot];
+    e->Y = Y[slot];
+    e->Z = Z[slot];
+    e->abs_X = abs_X[slot];
+    e->abs_Y = abs_Y[slot];
+    e->abs_Z = abs_Z[slot];
+    e->yaw = yaw[slot];
+    e->pitch = pitch[slot];
+    setSynced(slot);
+}
+
+//Remember the current position and direction of slot's object
+void EntityStore::setSynced(uint32_t slot)
+{
+    const Entity* e = object[slot];
+    if (e == NULL) {
+        return;
+    }
+    objectState_t& s = synced[slot];
+    s.X = e->X; s.Y = e->Y; s.Z = e->Z;
+    s.abs_X = e->abs_X; s.abs_Y = e->abs_Y; s.abs_Z = e->abs_Z;
+    s.yaw = e->yaw; s.pitch = e->pitch;
+}
+
+//Move slot to the grid cell of its position
+void EntityStore::updateCell(uint32_t slot)
+{
+    uint64_t key = getCellKey(X[slot], Z[slot]);
+    if (cellPos[slot] != npos) {
+        if (cellKey[slot] == key) {
+            return;
+        }
+        removeCell(slot);
+    }
+
+    std::vector<uint32_t>& cell = cells[key];
+    cellKey[slot] = key;
+    cellPos[slot] = cell.size();
+    cell.push_back(slot);
+}
+
+//Take slot out of its grid cell
+void EntityStore::removeCell(uint32_t slot)
+{
+    if (cellPos[slot] == npos) {
+        return;
+    }
+
+    //Swap last slot of cell into this position
+    cellMap_t::iterator iter = cells.find(cellKey[slot]);
+    std::vector<uint32_t>& cell = iter->second;
+    uint32_t last = cell.back();
+    cell[cellPos[slot]] = last;
+    cellPos[last] = cellPos[slot];
+    cell.pop_back();
+    cellPos[slot] = npos;
+
+    if (cell.empty()) {
+        cells.erase(iter);
+    }
+}
+
+//Add slots of entities within radius of x,y,z (blocks) to result
+size_t EntityStore::findInRadius(double x, double y, double z,
+    double radius, std::vector<uint32_t>& result) const
+{
+    //Check entities in bounding box of sphere
+    size_t first = result.size();
+    findInBox(x - radius, y - radius, z - radius,
+        x + radius, y + radius, z + radius, result);
+
+    //Keep the ones inside the sphere
+    size_t kept = first;
+    double r2 = radius*radius;
+    for (size_t i = first; i < result.size(); i++) {
+        uint32_t slot = result[i];
+        double dx = abs_X[slot] - x, dy = abs_Y[slot] - y,
+            dz = abs_Z[slot] - z;
+        if (dx*dx + dy*dy + dz*dz <= r2) {
+            result[kept++] = slot;
+        }
+    }
+    result.resize(kept);
+
+    return kept - first;
+}
+
+//Add slots of entities inside box (blocks) to result
+size_t EntityStore::findInBox(double x0, double y0, double z0,
+    double x1, double y1, double z1, std::vector<uint32_t>& result) const
+{
+    size_t first = result.size();
+
+    if (!(x0 <= x1 && y0 <= y1 && z0 <= z1)) {
+        return 0;
+    }
+
+    //Range of cells (1/32 block >> cell_SHIFT), clamped to the cells an
+    // int32_t position can be in
+    const double cell_BLOCKS = (1 << cell_SHIFT)/32.0;
+    const double cellMin =
+        (double)(std::numeric_limits<int32_t>::min() >> cell_SHIFT);
+    const double cellMax =
+        (double)(std::numeric_limits<int32_t>::max() >> cell_SHIFT);
+    double dx0 = std::max(cellMin, floor(x0/cell_BLOCKS));
+    double dx1 = std::min(cellMax, floor(x1/cell_BLOCKS));
+    double dz0 = std::max(cellMin, floor(z0/cell_BLOCKS));
+    double dz1 = std::min(cellMax, floor(z1/cell_BLOCKS));
+
+    //Box covers more cells than are in use: check every entity instead
+    if ((dx1 - dx0 + 1)*(dz1 - dz0 + 1) > (double)cells.size()) {
+        for (uint32_t slot = 0; slot < kind.size(); slot++) {
+            if (kind[slot] != KIND_NONE &&
+                abs_X[slot] >= x0 && abs_X[slot] <= x1 &&
+                abs_Y[slot] >= y0 && abs_Y[slot] <= y1 &&
+                abs_Z[slot] >= z0 && abs_Z[slot] <= z1)
+            {
+                result.push_back(slot);
+            }
+        }
+        return result.size() - first;
+    }
+
+    int32_t cx0 = (int32_t)dx0, cx1 = (int32_t)dx1;
+    int32_t cz0 = (int32_t)dz0, cz1 = (int32_t)dz1;
+    for (int32_t cx = cx0; cx <= cx1; cx++) {
+    for (int32_t cz = cz0; cz <= cz1; cz++) {
+        cellMap_t::const_iterator iter = cells.find(getCellKeyOf(cx, cz));
+        if (iter == cells.end()) {
+            continue;
+        }
+
+        //Check each entity in cell
+        const std::vector<uint32_t>& cell = iter->second;
+        std::vector<uint32_t>::const_iterator slot_iter;
+        for (slot_iter = cell.begin(); slot_iter != cell.end(); slot_iter++)
+        {
+            uint32_t slot = *slot_iter;
+            if (abs_X[slot] >= x0 && abs_X[slot] <= x1 &&
+                abs_Y[slot] >= y0 && abs_Y[slot] <= y1 &&
+                abs_Z[slot] >= z0 && abs_Z[slot] <= z1)
+            {
+                result.push_back(slot);
+            }
+        }
+    }
+    }
+
+    return result.size() - first;
+}
+
+//Seconds on the clock used for snapshots
+double EntityStore::now()
+{
+    return duration<double>(
+        steady_clock::now().time_since_epoch()).count();
+}
+
+//Set interpolation delay, extrapolation limit, snapshot interval (seconds)
+void EntityStore::setInterpolation(double delay, double limit,
+    double interval)
+{
+    interpDelay = delay;
+    extrapLimit = limit;
+    snapInterval = interval;
+}
+
+//Record position of slot at time.  Updates of the same batch as the
+// newest snapshot change its position but keep its time, so packets of one
+// tick don't make snapshots microseconds apart.  Ticks arriving early by
+// network jitter still get their own snapshot.
+void EntityStore::snapshot(uint32_t slot, double seconds)
+{
+    uint32_t base = slot*snap_MAX;
+    uint8_t newest = snapNewest[slot];
+    if (snapCount[slot] == 0 ||
+        seconds - snapTime[base + newest] > snap_BATCH)
+    {
+        newest = (newest + 1) % snap_MAX;
+        snapNewest[slot] = newest;
+        if (snapCount[slot] < snap_MAX) {
+            snapCount[slot]++;
+        }
+        snapTime[base + newest] = seconds;
+    }
+
+    uint32_t index = base + newest;
+    snapX[index] = X[slot];
+    snapY[index] = Y[slot];
+    snapZ[index] = Z[slot];
+    snapYaw[index] = yaw[slot];
+}
+
+//Draw positions for time: interpolate between snapshots delay seconds ago,
+// or extrapolate from the last two snapshots for up to limit seconds
+void EntityStore::interpolate(double seconds)
+{
+    double t = seconds - interpDelay;
+
+    for (uint32_t slot = 0; slot < EID.size(); slot++) {
+        if (kind[slot] == KIND_NONE || snapCount[slot] == 0) {
+            continue;
+        }
+        uint32_t base = slot*snap_MAX;
+        uint8_t count = snapCount[slot];
+
+        //Newer snapshot b, older snapshot a (a == b if only one)
+        uint8_t b = snapNewest[slot];
+        uint8_t a = (count > 1 ? (b + snap_MAX - 1) % snap_MAX : b);
+        double f;
+
+        if (snapTime[base + b] <= t) {
+            //Past newest snapshot: extrapolate with last velocity, over at
+            // least one snapshot interval so close snapshots can't fling it
+            double dt = snapTime[base + b] - snapTime[base + a];
+            double ahead = t - snapTime[base + b];
+            if (ahead > extrapLimit) {
+                ahead = extrapLimit;
+            }
+            if (dt < snapInterval) {
+                dt = snapInterval;
+            }
+            f = (a != b && dt > 0 ? 1.0 + ahead/dt : 1.0);
+        } else {
+            //Walk back until snapshot a is at or before t
+            for (uint8_t i = 2; i < count && snapTime[base + a] > t; i++) {
+                b = a;
+                a = (a + snap_MAX - 1) % snap_MAX;
+            }
+            double dt = snapTime[base + b] - snapTime[base + a];
+            f = (dt > 0 ? (t - snapTime[base + a])/dt : 1.0);
+            if (f < 0) {
+                f = 0;
+            }
+        }
+
+        //Blend positions (1/32 block to blocks), yaw the short way around
+        uint32_t ia = base + a, ib = base + b;
+        draw_X[slot] = (snapX[ia] + (snapX[ib] - snapX[ia])*f)/32.0f;
+        draw_Y[slot] = (snapY[ia] + (snapY[ib] - snapY[ia])*f)/32.0f;
+        draw_Z[slot] = (snapZ[ia] + (snapZ[ib] - snapZ[ia])*f)/32.0f;
+        float dYaw = snapYaw[ib] - snapYaw[ia];
+        dYaw -= 360.0f*floor((dYaw + 180.0f)/360.0f);
+        draw_yaw[slot] = snapYaw[ia] + dYaw*f;
+    }
+}
@@ -0,0 +1,217 @@
+/*
+  mc__::EntityStore
+    Positions and directions of all entities, stored by slot in arrays
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__ENTITYSTORE_H
+#define MC__ENTITYSTORE_H
+
+//mc--
+#include "Entity.hpp"
+
+//STL
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+namespace mc__ {
+
+    //Store entity state as one array per field, indexed by slot.  Slots of
+    // destroyed entities are reused by the next added entity.
+    class EntityStore {
+        public:
+            //What the entity object is
+            enum kind_t { KIND_NONE=0, KIND_PLAYER, KIND_ITEM, KIND_ENTITY };
+
+            //Slot returned for unknown EID
+            static const uint32_t npos = 0xFFFFFFFF;
+
+            //Position snapshots kept per entity for interpolation
+            static const uint8_t snap_MAX = 4;
+
+            //Grid cells are 16x16 blocks in X,Z (1/32 block >> cell_SHIFT)
+            static const uint8_t cell_SHIFT = 9;
+
+            //Relative move and look, as received from server
+            typedef struct {
+                uint32_t eid;
+                int8_t dX, dY, dZ;
+                int8_t dYaw, dPitch;
+            } move_t;
+
+            //Constructor
+            EntityStore();
+
+            //Add entity, or update it if EID is known.  Returns slot.
+            uint32_t add(uint32_t eid, kind_t kind, uint8_t type_id,
+                mc__::Entity* object, int32_t x, int32_t y, int32_t z,
+                float yaw, float pitch);
+
+            //Forget entity and recycle its slot (false if not found)
+            bool remove(uint32_t eid);
+
+            //Forget all entities
+            void clear();
+
+            //Slot for EID (npos if not found)
+            uint32_t find(uint32_t eid) const {
+                slotMap_t::const_iterator iter = slotIndex.find(eid);
+                return (iter == slotIndex.end() ? npos : iter->second);
+            };
+
+            //Relative move and look of entity in slot, received at seconds.
+            //  Pass the same seconds for every packet of one network tick.
+            void move(uint32_t slot, int8_t dx, int8_t dy, int8_t dz,
+                double seconds=now())
+            {
+                X[slot] += dx;
+                Y[slot] += dy;
+                Z[slot] += dz;
+                abs_X[slot] = X[slot]*(1/32.0);
+                abs_Y[slot] = Y[slot]*(1/32.0);
+                abs_Z[slot] = Z[slot]*(1/32.0);
+                snapshot(slot, seconds);
+                updateCell(slot);
+            };
+            void look(uint32_t slot, int8_t dYaw, int8_t dPitch,
+                double seconds=now())
+            {
+                yaw[slot] += dYaw*(360.0f/256.0f);
+                pitch[slot] += dPitch*(360.0f/256.0f);
+                snapshot(slot, seconds);
+            };
+
+            //Make the object of slot agree with the store.  The store owns
+            // position and direction; the object holds a copy.  Fields
+            // written to the object since the last sync (Player::setPosLook,
+            // abs_X, yaw, ...) are taken into the store first, as a teleport,
+            // then the store is copied to the object.
+            void sync(uint32_t slot);
+
+            //Apply moves of known EIDs, converting each moved slot to
+            // doubles once.  Indexes of unknown EIDs are added to unknown.
+            //  Returns number of moves applied.
+            size_t applyMoves(const move_t* moves, size_t count,
+                std::vector<size_t>* unknown=NULL, double seconds=now());
+
+            //Add slots of entities within radius of x,y,z (blocks) to result
+            //  Returns number of slots added.
+            size_t findInRadius(double x, double y, double z, double radius,
+                std::vector<uint32_t>& result) const;
+
+            //Add slots of entities inside box (blocks) to result
+            //  Returns number of slots added.
+            size_t findInBox(double x0, double y0, double z0,
+                double x1, double y1, double z1,
+                std::vector<uint32_t>& result) const;
+
+            //Draw positions for time (seconds, default now): interpolated
+            // between snapshots delay seconds ago, or extrapolated from the
+            // last two snapshots for up to limit seconds.  Extrapolation
+            // velocity is taken over at least interval (a server tick).
+            void interpolate(double seconds=now());
+            void setInterpolation(double delay, double limit,
+                double interval=0.05);
+
+            //Snapshots held for slot, and time of the newest one (seconds)
+            uint8_t snapshots(uint32_t slot) const { return snapCount[slot]; };
+            double snapshotTime(uint32_t slot) const {
+                return snapTime[slot*snap_MAX + snapNewest[slot]];
+            };
+
+            //Seconds on the clock used for snapshots
+            static double now();
+
+            //Number of entities, and number of slots (used or free)
+            size_t size() const { return slotIndex.size(); };
+            size_t slots() const { return EID.size(); };
+
+            //Entity state by slot (kind is KIND_NONE for free slots)
+            std::vector<uint32_t> EID;
+            std::vector<uint8_t> kind;
+            std::vector<uint8_t> typeID;
+            std::vector<int32_t> X, Y, Z;       //1/32 block
+            std::vector<double> abs_X, abs_Y, abs_Z;    //blocks
+            std::vector<int16_t> dX, dY, dZ;    //velocity
+            std::vector<float> yaw, pitch;
+            std::vector<mc__::Entity*> object;  //Player, Item or Entity
+
+            //Position to draw by slot (blocks), set by interpolate
+            std::vector<float> draw_X, draw_Y, draw_Z, draw_yaw;
+
+        protected:
+            //Map EID -> slot
+            typedef std::unordered_map< uint32_t, uint32_t> slotMap_t;
+            slotMap_t slotIndex;
+
+            //Slots of removed entities
+            std::vector<uint32_t> freeSlots;
+
+            //Snapshot ring of snap_MAX per slot: time, position, yaw
+            std::vector<double> snapTime;
+            std::vector<int32_t> snapX, snapY, snapZ;
+            std::vector<float> snapYaw;
+            std::vector<uint8_t> snapNewest, snapCount;
+
+            //Position and direction last copied to the object of each slot,
+            // to find what was written to the object since
+            typedef struct {
+                int32_t X, Y, Z;
+                double abs_X, abs_Y, abs_Z;
+                float yaw, pitch;
+            } objectState_t;
+            std::vector<objectState_t> synced;
+
+            //Remember the current position and direction of slot's object
+            void setSynced(uint32_t slot);
+
+            //Interpolation delay, extrapolation limit, and shortest time
+            // extrapolation velocity is taken over (seconds)
+            double interpDelay, extrapLimit, snapInterval;
+
+            //Record position of slot at time, in the newest snapshot if it
+            // is from the same batch (within snap_BATCH seconds)
+            void snapshot(uint32_t slot, double seconds);
+
+            //Uniform grid: cell key -> slots, and cell key/position by slot
+            typedef std::unordered_map< uint64_t, std::vector<uint32_t> >
+                cellMap_t;
+            cellMap_t cells;
+            std::vector<uint64_t> cellKey;
+            std::vector<uint32_t> cellPos;
+
+            //Cell key for cell X,Z, and for X,Z in 1/32 block
+            static uint64_t getCellKeyOf(int32_t cx, int32_t cz) {
+                return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cz;
+            };
+            static uint64_t getCellKey(int32_t x, int32_t z) {
+                return getCellKeyOf(x >> cell_SHIFT, z >> cell_SHIFT);
+            };
+
+            //Move slot to the grid cell of its position, or out of the grid
+            void updateCell(uint32_t slot);
+            void removeCell(uint32_t slot);
+
+            //Slots moved in applyMoves (reused), and flag for each slot
+            std::vector<uint32_t> movedSlots;
+            std::vector<uint8_t> moved;
+    };
+}
+
+#endif
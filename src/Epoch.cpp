@@ -0,0 +1,134 @@
+/*
+  mc__::Epoch
+    Epoch based reclamation: delete shared objects only after every reader
+    that could still see them is done
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "Epoch.hpp"
+using mc__::Epoch;
+
+//STL
+#include <thread>   //yield
+using std::vector;
+
+//Static const definitions
+const uint8_t Epoch::epoch_SLOTS;
+
+//Constructor
+Epoch::Epoch(): global(1)
+{
+    for (uint8_t i = 0; i < epoch_SLOTS; i++) {
+        pins[i].store(0);
+    }
+}
+
+//Delete everything retired
+Epoch::~Epoch()
+{
+    vector<retired_t>::iterator iter;
+    for (iter = retired.begin(); iter != retired.end(); iter++) {
+        iter->second();
+    }
+}
+
+//Pin the current epoch
+Epoch::Guard::Guard(Epoch& e): epoch(e), slot(e.pin())
+{
+}
+
+//Unpin
+Epoch::Guard::~Guard()
+{
+    epoch.unpin(slot);
+}
+
+//Claim a reader slot at the current epoch
+uint8_t Epoch::pin()
+{
+    while (true) {
+        for (uint8_t i = 0; i < epoch_SLOTS; i++) {
+            //Pin must be visible before the reader loads any pointer
+            uint64_t expected = 0;
+            if (pins[i].load(std::memory_order_relaxed) == 0 &&
+                pins[i].compare_exchange_strong(expected, global.load()))
+            {
+                return i;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+//Release reader slot
+void Epoch::unpin(uint8_t slot)
+{
+    pins[slot].store(0, std::memory_order_release);
+}
+
+//Call deleter when no reader can see the object
+void Epoch::retire(deleter_t deleter)
+{
+    //Readers pinned at this epoch or later may have found it
+    uint64_t epoch = global.fetch_add(1);
+    std::lock_guard<std::mutex> guard(retiredLock);
+    retired.push_back(retired_t(epoch, deleter));
+}
+
+//Call deleters of objects no reader can see
+size_t Epoch::reclaim()
+{
+    //Oldest epoch still pinned
+    uint64_t oldest = global.load();
+    for (uint8_t i = 0; i < epoch_SLOTS; i++) {
+        uint64_t pinned = pins[i].load();
+        if (pinned != 0 && pinned < oldest) {
+            oldest = pinned;
+        }
+    }
+
+    //Retired before every pinned reader started
+    vector<retired_t> ready;
+    {
+        std::lock_guard<std::mutex> guard(retiredLock);
+        size_t count=0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].first < oldest) {
+                ready.push_back(retired[i]);
+            } else {
+                retired[count++] = retired[i];
+            }
+        }
+        retired.resize(count);
+    }
+
+    //Delete without holding the lock
+    vector<retired_t>::iterator iter;
+    for (iter = ready.begin(); iter != ready.end(); iter++) {
+        iter->second();
+    }
+    return ready.size();
+}
+
+//Retired objects not yet deleted
+size_t Epoch::pending() const
+{
+    std::lock_guard<std::mutex> guard(retiredLock);
+    return retired.size();
+}
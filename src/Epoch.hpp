@@ -0,0 +1,107 @@
+/*
+  mc__::Epoch
+    Epoch based reclamation: delete shared objects only after every reader
+    that could still see them is done
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__EPOCH_H
+#define MC__EPOCH_H
+
+//STL
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+//Compiler specific options
+#ifdef _MSC_VER
+    #include "ms_stdint.h"
+#else
+    #include <stdint.h>
+#endif
+
+namespace mc__ {
+
+    //Readers hold a Guard while using pointers they found.  A writer
+    // unlinks an object so no new reader can find it, then retires it.  It
+    // is deleted by reclaim once every guard that was held when it was
+    // retired is gone.
+    class Epoch {
+        public:
+            //Readers at the same time (more wait for a free slot)
+            static const uint8_t epoch_SLOTS = 64;
+
+            //Deletes a retired object
+            typedef std::function<void()> deleter_t;
+
+            //Constructor, epoch 1
+            Epoch();
+
+            //Delete everything retired, no guards may be held
+            ~Epoch();
+
+            //Pin the current epoch while in scope
+            class Guard {
+                public:
+                    Guard(Epoch& e);
+                    ~Guard();
+                protected:
+                    Epoch& epoch;
+                    uint8_t slot;
+                private:
+                    Guard( const Guard& g);
+                    Guard& operator=( const Guard& g);
+            };
+
+            //Call deleter when no reader can see the object.  Object must
+            // already be unlinked.
+            void retire(deleter_t deleter);
+
+            //Call deleters of objects no reader can see
+            //  Returns number of objects deleted.
+            size_t reclaim();
+
+            //Retired objects not yet deleted
+            size_t pending() const;
+
+        protected:
+            //Incremented by each retire
+            std::atomic<uint64_t> global;
+
+            //Epoch pinned by each reader slot (0 = free)
+            std::atomic<uint64_t> pins[epoch_SLOTS];
+
+            //Retired objects and the epoch they were retired in
+            typedef std::pair<uint64_t, deleter_t> retired_t;
+            std::vector<retired_t> retired;
+            mutable std::mutex retiredLock;
+
+            //Claim a reader slot at the current epoch
+            uint8_t pin();
+            void unpin(uint8_t slot);
+
+        private:
+            //Readers point to this
+            Epoch( const Epoch& e);
+            Epoch& operator=( const Epoch& e);
+    };
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+  mc__::SPSCQueue, mc__::MPSCQueue
+    Bounded lock-free FIFO queues for passing events between threads
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__EVENTQUEUE_H
+#define MC__EVENTQUEUE_H
+
+//STL
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+//Compiler specific options
+#ifdef _MSC_VER
+    #include "ms_stdint.h"
+#else
+    #include <stdint.h>
+#endif
+
+namespace mc__ {
+
+    //Keep counters written by different threads on different cache lines
+    const size_t cache_LINE = 64;
+
+    //Round capacity up to a power of 2
+    inline size_t queueCapacity(size_t n) {
+        size_t capacity = 2;
+        while (capacity < n) { capacity <<= 1; }
+        return capacity;
+    }
+
+    //Single producer, single consumer bounded FIFO
+    template <typename T>
+    class SPSCQueue {
+        public:
+            //Constructor, capacity is rounded up to a power of 2
+            SPSCQueue(size_t n=4096): capacity(queueCapacity(n)),
+                mask(capacity - 1), buffer(capacity), head(0), tail(0),
+                highWater(0), full(0)
+            {
+            };
+
+            //Add to back of queue (producer thread), false if full
+            bool push(const T& value) {
+                size_t t = tail.load(std::memory_order_relaxed);
+                size_t depth = t - head.load(std::memory_order_acquire);
+                if (depth >= capacity) {
+                    full.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                buffer[t & mask] = value;
+                tail.store(t + 1, std::memory_order_release);
+
+                //Deepest the queue has been
+                if (depth + 1 > highWater.load(std::memory_order_relaxed)) {
+                    highWater.store(depth + 1, std::memory_order_relaxed);
+                }
+                return true;
+            };
+
+            //Take front of queue (consumer thread), false if empty
+            bool pop(T& result) {
+                return (drain(&result, 1) == 1);
+            };
+
+            //Take up to max values into out (consumer thread), in order
+            //  Returns number of values taken.
+            size_t drain(T* out, size_t max) {
+                size_t h = head.load(std::memory_order_relaxed);
+                size_t count = tail.load(std::memory_order_acquire) - h;
+                if (count > max) {
+                    count = max;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    out[i] = buffer[(h + i) & mask];
+                }
+                head.store(h + count, std::memory_order_release);
+                return count;
+            };
+
+            //Metrics: values waiting, most ever waiting, pushes refused
+            size_t depth() const {
+                return tail.load(std::memory_order_acquire) -
+                    head.load(std::memory_order_acquire);
+            };
+            size_t getHighWater() const { return highWater.load(); };
+            size_t getFull() const { return full.load(); };
+            size_t getCapacity() const { return capacity; };
+
+        protected:
+            const size_t capacity, mask;
+            std::vector<T> buffer;
+
+            //Consumer position, producer position
+            alignas(cache_LINE) std::atomic<size_t> head;
+            alignas(cache_LINE) std::atomic<size_t> tail;
+            std::atomic<size_t> highWater, full;
+    };
+
+    //Multiple producer, single consumer bounded FIFO.  Each cell has a
+    // sequence number saying whether it is ready to write or to read.
+    template <typename T>
+    class MPSCQueue {
+        public:
+            //Constructor, capacity is rounded up to a power of 2
+            MPSCQueue(size_t n=4096): capacity(queueCapacity(n)),
+                mask(capacity - 1), cells(capacity), head(0), tail(0),
+                highWater(0), full(0)
+            {
+                for (size_t i = 0; i < capacity; i++) {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            };
+
+            //Add to back of queue (any thread), false if full
+            bool push(const T& value) {
+                size_t t = tail.load(std::memory_order_relaxed);
+                cell_t *cell;
+
+                //Claim the cell at tail
+                for (;;) {
+                    cell = &cells[t & mask];
+                    size_t sequence =
+                        cell->sequence.load(std::memory_order_acquire);
+                    intptr_t diff = (intptr_t)sequence - (intptr_t)t;
+                    if (diff == 0) {
+                        if (tail.compare_exchange_weak(t, t + 1,
+                            std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    } else if (diff < 0) {
+                        full.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    } else {
+                        t = tail.load(std::memory_order_relaxed);
+                    }
+                }
+
+                //Write value, then let consumer read it
+                cell->value = value;
+                cell->sequence.store(t + 1, std::memory_order_release);
+
+                //Deepest the queue has been (may miss a concurrent maximum).
+                //  Consumer may already be past this cell if other producers
+                //  published later cells, then there is nothing to record.
+                intptr_t waiting = (intptr_t)(t + 1 -
+                    head.load(std::memory_order_relaxed));
+                if (waiting <= 0) {
+                    return true;
+                }
+                size_t depth = ((size_t)waiting < capacity ?
+                    (size_t)waiting : capacity);
+                size_t high = highWater.load(std::memory_order_relaxed);
+                while (depth > high && !highWater.compare_exchange_weak(
+                    high, depth, std::memory_order_relaxed))
+                {
+                }
+                return true;
+            };
+
+            //Take front of queue (consumer thread), false if empty
+            bool pop(T& result) {
+                return (drain(&result, 1) == 1);
+            };
+
+            //Take up to max values into out (consumer thread), in order
+            //  Returns number of values taken.
+            size_t drain(T* out, size_t max) {
+                size_t h = head.load(std::memory_order_relaxed);
+                size_t count = 0;
+                while (count < max) {
+                    cell_t& cell = cells[h & mask];
+                    if (cell.sequence.load(std::memory_order_acquire) !=
+                        h + 1)
+                    {
+                        break;
+                    }
+                    out[count++] = cell.value;
+
+                    //Cell can be written again one lap later
+                    cell.sequence.store(h + capacity,
+                        std::memory_order_release);
+                    h++;
+                }
+                head.store(h, std::memory_order_relaxed);
+                return count;
+            };
+
+            //Metrics: values waiting, most ever waiting, pushes refused
+            size_t depth() const {
+                size_t t = tail.load(std::memory_order_acquire);
+                size_t h = head.load(std::memory_order_acquire);
+                return (t > h ? t - h : 0);
+            };
+            size_t getHighWater() const { return highWater.load(); };
+            size_t getFull() const { return full.load(); };
+            size_t getCapacity() const { return capacity; };
+
+        protected:
+            typedef struct cell_s {
+                std::atomic<size_t> sequence;
+                T value;
+                cell_s(): sequence(0), value() {};
+                cell_s(const cell_s&): sequence(0), value() {};
+            } cell_t;
+
+            const size_t capacity, mask;
+            std::vector<cell_t> cells;
+
+            //Consumer position, producer position
+            alignas(cache_LINE) std::atomic<size_t> head;
+            alignas(cache_LINE) std::atomic<size_t> tail;
+            std::atomic<size_t> highWater, full;
+    };
+}
+
+#endif
@@ -23,34 +23,312 @@
 #include "Events.hpp"
 using mc__::Events;
 
+//Static constants
+const size_t Events::get_BATCH;
+
 //Constructor
-Events::Events(): isEmpty(true)
+Events::Events(size_t capacity): isEmpty(true), myQueue(capacity),
+    coalescing(false), takenNext(0)
 {
+    coalesceStats.moves = 0;
+    coalesceStats.blocks = 0;
+    coalesceStats.actions = 0;
+
+    for (size_t i = 0; i < MC__EVENTS_MAX; i++) {
+        handlers[i] = NULL;
+    }
 }
 
 //Add events
-void Events::put(type_t t, const void *d)
+bool Events::put(type_t t, const void *d)
+{
+    Event_t event;
+    event.type = t;
+    event.data = d;
+    event.hasPayload = false;
+    return putEvent(event);
+}
+
+//Add events with data copied into them
+bool Events::put(type_t t, const dataLook& d)
+{
+    Event_t event;
+    event.type = t;
+    event.data = NULL;
+    event.payload.look = d;
+    event.hasPayload = true;
+    return putEvent(event);
+}
+
+bool Events::put(type_t t, const dataBlockChange& d)
+{
+    Event_t event;
+    event.type = t;
+    event.data = NULL;
+    event.payload.blockChange = d;
+    event.hasPayload = true;
+    return putEvent(event);
+}
+
+bool Events::put(type_t t, const dataRelMove& d)
+{
+    Event_t event;
+    event.type = t;
+    event.data = NULL;
+    event.payload.relMove = d;
+    event.hasPayload = true;
+    return putEvent(event);
+}
+
+bool Events::put(type_t t, const dataPosLook& d)
 {
-    Event_t event = { t, d};
-    myQueue.push_back( event );
+    Event_t event;
+    event.type = t;
+    event.data = NULL;
+    event.payload.posLook = d;
+    event.hasPayload = true;
+    return putEvent(event);
+}
+
+bool Events::put(type_t t, const dataMapChunk& d)
+{
+    Event_t event;
+    event.type = t;
+    event.data = NULL;
+    event.payload.mapChunk = d;
+    event.hasPayload = true;
+    return putEvent(event);
+}
+
+//Put event (data pointer is set again when event is taken)
+bool Events::putEvent(Event_t& event)
+{
+    if (!myQueue.push( event )) {
+        return false;
+    }
     isEmpty = false;
+    return true;
 }
 
-//Pop the next event off the list, return false if not found
+//Take the oldest event off the queue, return false if not found
 bool Events::get(Event_t& result) {
     
-    if (myQueue.empty()) {
+    //Take and merge a batch when coalescing
+    if (takenNext == taken.size() && coalescing) {
+        Event_t batch[get_BATCH];
+        taken.clear();
+        takenNext = 0;
+        size_t count = drain(batch, get_BATCH);
+        taken.assign(batch, batch + count);
+    }
+    
+    if (takenNext < taken.size()) {
+        result = taken[takenNext++];
+    } else if (!myQueue.pop(result)) {
         isEmpty = true;
         return false;
     }
     
-    result = myQueue.back();
-    myQueue.pop_back();
+    //Point to payload in caller's copy
+    result.data = getData(result);
+
+    return true;
+}
 
-    if (myQueue.empty()) {
+//Take up to max oldest events, return number taken
+size_t Events::drain(Event_t* out, size_t max)
+{
+    //Events get took already come first
+    size_t count = 0;
+    while (takenNext < taken.size() && count < max) {
+        out[count++] = taken[takenNext++];
+    }
+    size_t first = count;
+    
+    count += myQueue.drain(out + count, max - count);
+    if (count < max) {
         isEmpty = true;
-        return false;
     }
+    
+    //Merge redundant events (ones get took are merged already)
+    if (coalescing) {
+        count = first + coalesce(out + first, count - first);
+    }
+    
+    //Point to payloads in caller's copies
+    for (size_t i = 0; i < count; i++) {
+        out[i].data = getData(out[i]);
+    }
+    return count;
+}
 
-    return true;
+//Merge events in batch, returns new count
+size_t Events::coalesce(Event_t* events, size_t count)
+{
+    //Table at most half full, cleared for this batch
+    size_t tableSize = 16;
+    while (tableSize < count*2) { tableSize <<= 1; }
+    if (coalesceTable.size() < tableSize) {
+        coalesceTable.resize(tableSize);
+    }
+    tableSize = coalesceTable.size();
+    for (size_t i = 0; i < tableSize; i++) {
+        coalesceTable[i].type = MC__EVENTS_MAX;
+    }
+    
+    //Events are only merged with earlier ones since the last barrier
+    // of their kind.  Barrier data is not stored in the event, so its EID
+    // or coordinates are unknown and it stops merging for all of them.
+    uint32_t entityBarrier = 0, blockBarrier = 0;
+    
+    bool merged = false;
+    for (size_t i = 0; i < count; i++) {
+        Event_t& event = events[i];
+        
+        //Key for events that can be merged
+        int32_t a = 0, b = 0, c = 0;
+        uint32_t barrier = 0;
+        switch (event.type) {
+            case GAME_ENT_REL_MOVE:
+            case GAME_ENT_LOOK:
+            case GAME_ENT_LOOK_MOVE:
+                if (!event.hasPayload) { continue; }
+                a = event.payload.relMove.eid;
+                barrier = entityBarrier;
+                break;
+            case GAME_BLOCK_CHANGE:
+                if (!event.hasPayload) { continue; }
+                a = event.payload.blockChange.X;
+                b = event.payload.blockChange.Y;
+                c = event.payload.blockChange.Z;
+                barrier = blockBarrier;
+                break;
+            case ACTION_POS:
+            case ACTION_LOOK:
+            case ACTION_POSLOOK:
+                break;
+                
+            //Absolute position or lifecycle of an entity
+            case GAME_LOGIN:
+            case GAME_PLAYER_RESPAWN:
+            case GAME_NAMED_SPAWN:
+            case GAME_ITEM_SPAWN:
+            case GAME_COLLECT_ITEM:
+            case GAME_ADD_OBJECT:
+            case GAME_MOB_SPAWN:
+            case GAME_ENT_PAINTING:
+            case GAME_ADD_EXP_ORB:
+            case GAME_DESTROY_ENTITY:
+            case GAME_ENT_TELEPORT:
+            case GAME_ENT_VEHICLE:
+                entityBarrier++;
+                continue;
+                
+            //Blocks set by chunk data
+            case GAME_PRECHUNK:
+            case GAME_MAPCHUNK:
+            case GAME_MULTI_BLOCK_CHANGE:
+            case GAME_MAPCHUNK_BULK:
+                blockBarrier++;
+                continue;
+                
+            default:
+                continue;
+        }
+        
+        //Find earlier event with the same key
+        size_t hash = ((uint32_t)event.type*0x9E3779B1u) ^
+            ((uint32_t)a*0x85EBCA6Bu) ^ ((uint32_t)b*0xC2B2AE35u) ^
+            ((uint32_t)c*0x27D4EB2Fu) ^ (barrier*0x165667B1u);
+        size_t slot = (hash ^ (hash >> 15)) & (tableSize - 1);
+        while (coalesceTable[slot].type != MC__EVENTS_MAX &&
+            !(coalesceTable[slot].type == (uint32_t)event.type &&
+                coalesceTable[slot].a == a && coalesceTable[slot].b == b &&
+                coalesceTable[slot].c == c &&
+                coalesceTable[slot].barrier == barrier))
+        {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        coalesceSlot_t& entry = coalesceTable[slot];
+        
+        if (entry.type != MC__EVENTS_MAX) {
+            Event_t& earlier = events[entry.index];
+            
+            if (event.hasPayload && (event.type == GAME_ENT_REL_MOVE ||
+                event.type == GAME_ENT_LOOK ||
+                event.type == GAME_ENT_LOOK_MOVE))
+            {
+                //Add earlier move to this one, if it still fits
+                dataRelMove& m = event.payload.relMove;
+                const dataRelMove& e = earlier.payload.relMove;
+                int dX = m.dX + e.dX, dY = m.dY + e.dY, dZ = m.dZ + e.dZ;
+                if (dX < -128 || dX > 127 || dY < -128 || dY > 127 ||
+                    dZ < -128 || dZ > 127)
+                {
+                    entry.index = i;
+                    continue;
+                }
+                m.dX = dX; m.dY = dY; m.dZ = dZ;
+                m.dYaw += e.dYaw;       //Angles wrap around
+                m.dPitch += e.dPitch;
+                coalesceStats.moves++;
+            } else if (event.type == GAME_BLOCK_CHANGE) {
+                coalesceStats.blocks++;
+            } else {
+                coalesceStats.actions++;
+            }
+            
+            //Drop earlier event
+            earlier.type = MC__EVENTS_MAX;
+            merged = true;
+        } else {
+            entry.type = event.type;
+            entry.a = a; entry.b = b; entry.c = c;
+            entry.barrier = barrier;
+        }
+        entry.index = i;
+    }
+    
+    if (!merged) {
+        return count;
+    }
+    
+    //Remove dropped events, keeping order
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].type != MC__EVENTS_MAX) {
+            events[kept++] = events[i];
+        }
+    }
+    return kept;
+}
+
+//Call cb for events of type t
+void Events::setHandler(type_t t, CB cb)
+{
+    handlers[t] = cb;
+}
+
+//Get events and call their handlers, return number of events taken
+size_t Events::dispatch(size_t max)
+{
+    Event_t batch[256];
+    size_t total = 0;
+    
+    while (total < max) {
+        size_t wanted = (max - total < 256 ? max - total : 256);
+        size_t count = drain(batch, wanted);
+        for (size_t i = 0; i < count; i++) {
+            CB cb = handlers[batch[i].type];
+            if (cb != NULL) {
+                cb(batch[i].type, batch[i].data);
+            }
+        }
+        total += count;
+        if (count == 0 || (!coalescing && count < wanted)) {
+            break;
+        }
+    }
+    
+    return total;
 }
@@ -22,8 +22,12 @@
 #ifndef MC__EVENTS_H
 #define MC__EVENTS_H
 
+//mc--
+#include "EventQueue.hpp"
+
 //STL
-#include <deque>
+#include <atomic>
+#include <vector>
 
 //Compiler specific options
 #ifdef _MSC_VER
@@ -130,12 +134,6 @@ namespace mc__ {
                 MC__EVENTS_MAX
             };
             
-            //Generic data for event callback
-            typedef struct {
-                type_t type;
-                const void *data;
-            } Event_t;
-            
             //Data types for callback data
             typedef struct {
                 float yaw;
@@ -143,22 +141,147 @@ namespace mc__ {
                 uint8_t animation;  //0=ground
             } dataLook;
             
+            //GAME_BLOCK_CHANGE
+            typedef struct {
+                int32_t X, Z;
+                int8_t Y;
+                uint8_t blockID, metadata;
+            } dataBlockChange;
+            
+            //GAME_ENT_REL_MOVE, GAME_ENT_LOOK, GAME_ENT_LOOK_MOVE
+            typedef struct {
+                uint32_t eid;
+                int8_t dX, dY, dZ;
+                int8_t dYaw, dPitch;
+            } dataRelMove;
+            
+            //GAME_PLAYER_POSLOOK
+            typedef struct {
+                double X, Y, Z, stance;
+                float yaw, pitch;
+                uint8_t on_ground;
+            } dataPosLook;
+            
+            //GAME_MAPCHUNK: map chunk that was added or changed in World
+            typedef struct {
+                int32_t X, Z;
+                int16_t Y;
+                uint8_t size_X, size_Y, size_Z;
+            } dataMapChunk;
+            
+            //Event data stored in the event itself
+            typedef union {
+                dataLook look;
+                dataBlockChange blockChange;
+                dataRelMove relMove;
+                dataPosLook posLook;
+                dataMapChunk mapChunk;
+            } payload_t;
+            
+            //Generic data for event callback: data points to payload if it
+            // was stored in the event, otherwise to the caller's data
+            typedef struct {
+                type_t type;
+                const void *data;
+                payload_t payload;
+                bool hasPayload;
+            } Event_t;
+            
             //Function pointers
             typedef uint8_t(*CB)(type_t t, const void* d);
             
-            Events();
+            //Events merged by coalescing
+            typedef struct {
+                uint32_t moves;     //Relative moves added to a later one
+                uint32_t blocks;    //Block changes replaced by a later one
+                uint32_t actions;   //Player position/look replaced
+            } coalesceStats_t;
+            
+            //Constructor, capacity is rounded up to a power of 2
+            Events(size_t capacity=4096);
             
-            //Add event
-            void put(type_t t, const void *d);
+            //Add event (any thread), false if queue is full
+            bool put(type_t t, const void *d);
             
-            //Get next unhandled event
+            //Add event with data copied into it (no allocation)
+            bool put(type_t t, const dataLook& d);
+            bool put(type_t t, const dataBlockChange& d);
+            bool put(type_t t, const dataRelMove& d);
+            bool put(type_t t, const dataPosLook& d);
+            bool put(type_t t, const dataMapChunk& d);
+            
+            //Get oldest unhandled event (one thread), false if none
+            //  When coalescing, events are taken in batches of get_BATCH,
+            //  merged, and returned one at a time.
             bool get(Event_t& result);
             
-            //Empty/not empty
-            bool isEmpty;
+            //Get up to max oldest events into out, returns number taken
+            //  (data points into out; use getData after copying an event)
+            size_t drain(Event_t* out, size_t max);
+            
+            //Data pointer for event (its payload, or the caller's data)
+            static const void* getData(const Event_t& event) {
+                return (event.hasPayload ? &event.payload : event.data);
+            };
+            
+            //Merge pending events when they are taken (get, drain and
+            // dispatch): relative moves of
+            // the same entity are added, block changes of the same block and
+            // local player position/look actions are replaced by the latest.
+            //  Moves are not merged across entity spawn, teleport or destroy
+            //  events, nor block changes across chunk data.
+            void setCoalescing(bool on) { coalescing = on; };
+            const coalesceStats_t& getCoalesceStats() const {
+                return coalesceStats;
+            };
+            
+            //Call cb for events of type t (NULL to stop)
+            void setHandler(type_t t, CB cb);
+            
+            //Get up to max events and call their handlers.  Events without
+            // a handler are dropped.  Returns number of events taken.
+            size_t dispatch(size_t max=1024);
+            
+            //Queue metrics: events waiting, most ever waiting, events
+            // refused because queue was full
+            size_t depth() const { return myQueue.depth(); };
+            size_t highWater() const { return myQueue.getHighWater(); };
+            size_t dropped() const { return myQueue.getFull(); };
+            
+            //Empty/not empty (hint for polling, get() is exact)
+            std::atomic<bool> isEmpty;
             
         protected:
-            std::deque<Event_t> myQueue;
+            mc__::MPSCQueue<Event_t> myQueue;
+            
+            //Handler for each event type
+            CB handlers[MC__EVENTS_MAX];
+            
+            //Put event with payload already set
+            bool putEvent(Event_t& event);
+            
+            //Coalescing option, counters, and open addressed table of
+            // (type, coordinates or EID, barrier count) -> latest event
+            // index.  Barriers are events that events of a kind must not be
+            // merged across (teleport, spawn, chunk data...).
+            bool coalescing;
+            coalesceStats_t coalesceStats;
+            typedef struct {
+                uint32_t type;
+                int32_t a, b, c;
+                uint32_t barrier;
+                uint32_t index;
+            } coalesceSlot_t;
+            std::vector<coalesceSlot_t> coalesceTable;
+            
+            //Merge events in batch, returns new count
+            size_t coalesce(Event_t* events, size_t count);
+            
+            //Coalesced events taken by get but not returned yet, and the
+            // next one to return.  Taken before the queue by get and drain.
+            static const size_t get_BATCH = 256;
+            std::vector<Event_t> taken;
+            size_t takenNext;
 
     };
 }
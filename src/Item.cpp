@@ -24,7 +24,6 @@
 
 using mc__::Item;
 using mc__::Entity;
-using std::string;
 
 //Constructor
 Item::Item( uint16_t iid, uint8_t c, uint8_t d, uint32_t eid):
@@ -34,7 +33,7 @@ Item::Item( uint16_t iid, uint8_t c, uint8_t d, uint32_t eid):
 }
 
 //Get name for this item's ID
-string Item::getName() const
+const char* Item::getName() const
 {
     //Check for special cases
     uint16_t ID = itemID;
@@ -46,339 +45,360 @@ string Item::getName() const
     return getString(ID);
 }
 
+//Item names in runs of consecutive IDs
+static const char* const blockNames[] = {   //Blocks
+    "Air",                    //0
+    "Stone",                  //1
+    "Grass",                  //2
+    "Dirt",                   //3
+    "Cobblestone",            //4
+    "Wood",                   //5
+    "Sapling",                //6
+    "Bedrock",                //7
+    "Water",                  //8
+    "Stationary water",       //9
+    "Lava",                   //10
+    "Stationary lava",        //11
+    "Sand",                   //12
+    "Gravel",                 //13
+    "Gold ore",               //14
+    "Iron ore",               //15
+    "Coal ore",               //16
+    "Log",                    //17
+    "Leaves",                 //18
+    "Sponge",                 //19
+    "Glass",                  //20
+    "Lapis ore",              //21
+    "Lapis block",            //22
+    "Dispenser",              //23
+    "Sandstone",              //24
+    "Note block",             //25
+    "Bed",                    //26
+    "Powered Rail",           //27
+    "Detector Rail",          //28
+    "Sticky Piston",          //29
+    "Web",                    //30
+    "Tall Grass",             //31
+    "Dead Bush",              //32
+    "Piston",                 //33
+    "Piston Head",            //34
+    "Wool",                   //35
+    "Web",                    //36
+    "Yellow flower",          //37
+    "Red rose",               //38
+    "Brown mushroom",         //39
+    "Red mushroom",           //40
+    "Gold block",             //41
+    "Iron block",             //42
+    "Double stone slab",      //43
+    "Stone slab",             //44
+    "Brick",                  //45
+    "TNT",                    //46
+    "Bookshelf",              //47
+    "Moss stone",             //48
+    "Obsidian",               //49
+    "Torch",                  //50
+    "Fire",                   //51
+    "Monster spawn",          //52
+    "Wooden stairs",          //53
+    "Chest",                  //54
+    "Redstone wire",          //55
+    "Diamond ore",            //56
+    "Diamond block",          //57
+    "Workbench",              //58
+    "Crops",                  //59
+    "Soil",                   //60
+    "Furnace",                //61
+    "Lit furnace",            //62
+    "Sign post",              //63
+    "Wooden door",            //64
+    "Ladder",                 //65
+    "Track",                  //66
+    "Cobblestone stairs",     //67
+    "Wall sign",              //68
+    "Lever",                  //69
+    "Stone floorplate",       //70
+    "Iron door",              //71
+    "Wooden floorplate",      //72
+    "Redstone ore",           //73
+    "Glowing redstone",       //74
+    "Redstone torch",         //75
+    "Lit redstone torch",     //76
+    "Stone button",           //77
+    "Snow",                   //78
+    "Ice",                    //79
+    "Snow block",             //80
+    "Cactus",                 //81
+    "Clay",                   //82
+    "Reed",                   //83
+    "Jukebox",                //84
+    "Fence",                  //85
+    "Pumpkin",                //86
+    "Netherrack",             //87
+    "Soul sand",              //88
+    "Glowstone",              //89
+    "Portal",                 //90
+    "Jack-O-Lantern",         //91
+    "Cake",                   //92
+    "Diode",                  //93
+    "Diode Lit",              //94
+    "Locked Chest",           //95
+    "Trap Door",              //96
+    "Monster Egg",            //97
+    "Stone Bricks",           //98
+    "Huge Brown Mushroom",    //99
+    "Huge Red Mushroom",      //100
+    "Iron Bars",              //101
+    "Glass Pane",             //102
+    "Melon",                  //103
+    "Pumpkin Stem",           //104
+    "Melon Stem",             //105
+    "Vines",                  //106
+    "Fence Gate",             //107
+    "Brick Stairs",           //108
+    "Stone Brick Stairs",     //109
+    "Mycelium",               //110
+    "Lily Pad",               //111
+    "Nether Brick",           //112
+    "Nether Brick Fence",     //113
+    "Nether Brick Stairs",    //114
+    "Nether Wart",            //115
+    "Enchantment Table",      //116
+    "Brewing Stand",          //117
+    "Cauldron",               //118
+    "End Portal",             //119
+    "End Portal Frame",       //120
+    "End Stone",              //121
+    "Dragon Egg",             //122
+    "Redstone Lamp Off",      //123
+    "Redstone Lamp On",       //124
+    "Wooden Double Slab",     //125
+    "Wooden Slab",            //126
+    "Cocoa Plant",            //127
+    "Sandstone Stairs",       //128
+    "Emerald Ore",            //129
+    "Ender Chest",            //130
+    "Tripwire Hook",          //131
+    "Tripwire",               //132
+    "Block of Emerald",       //133
+    "Spruce Wood Stairs",     //134
+    "Birch Wood Stairs",      //135
+    "Jungle Wood Stairs",     //136
+    "Command Block",          //137
+    "Beacon Block",           //138
+    "Cobblestone Wall",       //139
+    "Flower Pot",             //140
+    "Carrots",                //141
+    "Potatoes",               //142
+    "Wooden Button ",         //143
+};
+
+static const char* const itemNames[] = {   //Items
+    "Iron shovel",            //256
+    "Iron pickaxe",           //257
+    "Iron axe",               //258
+    "Flint and steel",        //259
+    "Apple",                  //260
+    "Bow",                    //261
+    "Arrow",                  //262
+    "Coal",                   //263
+    "Diamond",                //264
+    "Iron ingot",             //265
+    "Gold ingot",             //266
+    "Iron sword",             //267
+    "Wooden sword",           //268
+    "Wooden shovel",          //269
+    "Wooden pickaxe",         //270
+    "Wooden axe",             //271
+    "Stone sword",            //272
+    "Stone shovel",           //273
+    "Stone pickaxe",          //274
+    "Stone axe",              //275
+    "Diamond sword",          //276
+    "Diamond shovel",         //277
+    "Diamond pickaxe",        //278
+    "Diamond axe",            //279
+    "Stick",                  //280
+    "Bowl",                   //281
+    "Mushroom soup",          //282
+    "Gold sword",             //283
+    "Gold shovel",            //284
+    "Gold pickaxe",           //285
+    "Gold axe",               //286
+    "String",                 //287
+    "Feather",                //288
+    "Sulphur",                //289
+    "Wooden hoe",             //290
+    "Stone hoe",              //291
+    "Iron hoe",               //292
+    "Diamond hoe",            //293
+    "Gold hoe",               //294
+    "Seeds",                  //295
+    "Wheat",                  //296
+    "Bread",                  //297
+    "Leather helmet",         //298
+    "Leather tunic",          //299
+    "Leather leggings",       //300
+    "Leather boots",          //301
+    "Chainmail helmet",       //302
+    "Chainmail tunic",        //303
+    "Chainmail leggings",     //304
+    "Chainmail boots",        //305
+    "Iron helmet",            //306
+    "Iron mail",              //307
+    "Iron leggings",          //308
+    "Iron boots",             //309
+    "Diamond helmet",         //310
+    "Diamond mail",           //311
+    "Diamond leggings",       //312
+    "Diamond boots",          //313
+    "Gold helmet",            //314
+    "Gold chestplate",        //315
+    "Gold leggings",          //316
+    "Gold boots",             //317
+    "Flint",                  //318
+    "Raw porkchop",           //319
+    "Cooked porkchop",        //320
+    "Paintings",              //321
+    "Golden apple",           //322
+    "Sign",                   //323
+    "Wooden door",            //324
+    "Bucket",                 //325
+    "Water bucket",           //326
+    "Lava bucket",            //327
+    "Mine cart",              //328
+    "Saddle",                 //329
+    "Iron door",              //330
+    "Redstone",               //331
+    "Snowball",               //332
+    "Boat",                   //333
+    "Leather",                //334
+    "Milk",                   //335
+    "Clay brick",             //336
+    "Clay balls",             //337
+    "Reed",                   //338
+    "Paper",                  //339
+    "Book",                   //340
+    "Slimeball",              //341
+    "Storage cart",           //342
+    "Powered cart",           //343
+    "Egg",                    //344
+    "Compass",                //345
+    "Fishing rod",            //346
+    "Clock",                  //347
+    "Glowstone dust",         //348
+    "Raw fish",               //349
+    "Cooked fish",            //350
+    "Dye",                    //351
+    "Bone",                   //352
+    "Sugar",                  //353
+    "Cake",                   //354
+    "Bed",                    //355
+    "Diode",                  //356
+    "Cookie",                 //357
+    "Map",                    //358
+    "Shears",                 //359
+    "Melon Slice",            //360
+    "Pumpkin Seeds",          //361
+    "Melon Seeds",            //362
+    "Raw Beef",               //363
+    "Steak",                  //364
+    "Raw Chicken",            //365
+    "Cooked Chicken",         //366
+    "Rotten Flesh",           //367
+    "Ender Pearl",            //368
+    "Blaze Rod",              //369
+    "Ghast Tear",             //370
+    "Gold Nugget",            //371
+    "Nether Wart",            //372
+    "Potions D",              //373
+    "Glass Bottle",           //374
+    "Spider Eye",             //375
+    "Fermented Spider Eye",   //376
+    "Blaze Powder",           //377
+    "Magma Cream",            //378
+    "Brewing Stand",          //379
+    "Cauldron",               //380
+    "Eye of Ender",           //381
+    "Glistering Melon",       //382
+    "Spawn Egg D",            //383
+    "Bottle o' Enchanting",   //384
+    "Fire Charge",            //385
+    "Book and Quill",         //386
+    "Written Book",           //387
+    "Emerald",                //388
+    "Item Frame",             //389
+    "Flower Pot",             //390
+    "Carrots",                //391
+    "Potato",                 //392
+    "Baked Potato",           //393
+    "Poisonous Potato",       //394
+    "Map",                    //395
+    "Golden Carrot",          //396
+    "Record",                 //397
+};
+
+static const char* const dyeNames[] = {   //Dyes: (("Item ID" - 256) * 16) + damage = fake ID
+    "Ink Sack",               //1520
+    "Rose dye",               //1521
+    "Cactus dye",             //1522
+    "Cocoa dye",              //1523
+    "Lapis dye",              //1524
+    "Purple dye",             //1525
+    "Cyan dye",               //1526
+    "Light gray dye",         //1527
+    "Gray dye",               //1528
+    "Pink dye",               //1529
+    "Lime dye",               //1530
+    "Yellow dye",             //1531
+    "Light Blue dye",         //1532
+    "Magenta dye",            //1533
+    "Orange dye",             //1534
+    "Bone meal",              //1535
+};
+
+static const char* const discNames[] = {   //Discs
+    "13 Disc",                //2256
+    "Cat Disc",               //2257
+    "blocks Disc",            //2258
+    "chirp Disc",             //2259
+    "far Disc",               //2260
+    "mall Disc",              //2261
+    "mellohi Disc",           //2262
+    "stal Disc",              //2263
+    "strad Disc",             //2264
+    "ward Disc",              //2265
+    "11 Disc",                //2266
+};
+
+//First ID and length of each run
+typedef struct {
+    uint16_t first;
+    size_t count;
+    const char* const *names;
+} nameRun_t;
+static const nameRun_t nameRuns[] = {
+    { 0, sizeof(blockNames)/sizeof(blockNames[0]), blockNames },
+    { 256, sizeof(itemNames)/sizeof(itemNames[0]), itemNames },
+    { 1520, sizeof(dyeNames)/sizeof(dyeNames[0]), dyeNames },
+    { 2256, sizeof(discNames)/sizeof(discNames[0]), discNames },
+};
+
 //(static function) Get string for an item ID
-string Item::getString( uint16_t iid, uint8_t offset)
+const char* Item::getString( uint16_t iid, uint8_t offset)
 {
-    string result;
-    
+    uint32_t ID = (uint32_t)iid + offset;
+
     //String depends on itemID
-    switch(iid + offset) {
-        case 0: result =  "Air"; break;
-        case 1: result =  "Stone"; break;
-        case 2: result =  "Grass"; break;
-        case 3: result =  "Dirt"; break;
-        case 4: result =  "Cobblestone"; break;
-        case 5: result =  "Wood"; break;
-        case 6: result =  "Sapling"; break;
-        case 7: result =  "Bedrock"; break;
-        case 8: result =  "Water"; break;
-        case 9: result =  "Stationary water"; break;
-        case 10: result = "Lava"; break;
-        case 11: result = "Stationary lava"; break;
-        case 12: result = "Sand"; break;
-        case 13: result = "Gravel"; break;
-        case 14: result = "Gold ore"; break;
-        case 15: result = "Iron ore"; break;
-        case 16: result = "Coal ore"; break;
-        case 17: result = "Log"; break;
-        case 18: result = "Leaves"; break;
-        case 19: result = "Sponge"; break;
-        case 20: result = "Glass"; break;
-        case 21: result = "Lapis ore"; break;
-        case 22: result = "Lapis block"; break;
-        case 23: result = "Dispenser"; break;
-        case 24: result = "Sandstone"; break;
-        case 25: result = "Note block"; break;
-        case 26: result = "Bed"; break;
-        case 27: result = "Powered Rail"; break;
-        case 28: result = "Detector Rail"; break;
-        case 29: result = "Sticky Piston"; break;
-        case 30: result = "Web"; break;
-        case 31: result = "Tall Grass"; break;
-        case 32: result = "Dead Bush"; break;
-        case 33: result = "Piston"; break;
-        case 34: result = "Piston Head"; break;
-        case 35: result = "Wool"; break;
-        case 36: result = "Web"; break;
-        case 37: result = "Yellow flower"; break;
-        case 38: result = "Red rose"; break;
-        case 39: result = "Brown mushroom"; break;
-        case 40: result = "Red mushroom"; break;
-        case 41: result = "Gold block"; break;
-        case 42: result = "Iron block"; break;
-        case 43: result = "Double stone slab"; break;
-        case 44: result = "Stone slab"; break;
-        case 45: result = "Brick"; break;
-        case 46: result = "TNT"; break;
-        case 47: result = "Bookshelf"; break;
-        case 48: result = "Moss stone"; break;
-        case 49: result = "Obsidian"; break;
-        case 50: result = "Torch"; break;
-        case 51: result = "Fire"; break;
-        case 52: result = "Monster spawn"; break;
-        case 53: result = "Wooden stairs"; break;
-        case 54: result = "Chest"; break;
-        case 55: result = "Redstone wire"; break;
-        case 56: result = "Diamond ore"; break;
-        case 57: result = "Diamond block"; break;
-        case 58: result = "Workbench"; break;
-        case 59: result = "Crops"; break;
-        case 60: result = "Soil"; break;
-        case 61: result = "Furnace"; break;
-        case 62: result = "Lit furnace"; break;
-        case 63: result = "Sign post"; break;
-        case 64: result = "Wooden door"; break;
-        case 65: result = "Ladder"; break;
-        case 66: result = "Track"; break;
-        case 67: result = "Cobblestone stairs"; break;
-        case 68: result = "Wall sign"; break;
-        case 69: result = "Lever"; break;
-        case 70: result = "Stone floorplate"; break;
-        case 71: result = "Iron door"; break;
-        case 72: result = "Wooden floorplate"; break;
-        case 73: result = "Redstone ore"; break;
-        case 74: result = "Glowing redstone"; break;
-        case 75: result = "Redstone torch"; break;
-        case 76: result = "Lit redstone torch"; break;
-        case 77: result = "Stone button"; break;
-        case 78: result = "Snow"; break;
-        case 79: result = "Ice"; break;
-        case 80: result = "Snow block"; break;
-        case 81: result = "Cactus"; break;
-        case 82: result = "Clay"; break;
-        case 83: result = "Reed"; break;
-        case 84: result = "Jukebox"; break;
-        case 85: result = "Fence"; break;
-        case 86: result = "Pumpkin"; break;
-        case 87: result = "Netherrack"; break;
-        case 88: result = "Soul sand"; break;
-        case 89: result = "Glowstone"; break;
-        case 90: result = "Portal"; break;
-        case 91: result = "Jack-O-Lantern"; break;
-        case 92: result = "Cake"; break;
-        case 93: result = "Diode"; break;
-        case 94: result = "Diode Lit"; break;
-        case 95: result = "Locked Chest"; break;
-        case 96: result = "Trap Door"; break;
-        case 97: result = "Monster Egg"; break;
-        case 98: result = "Stone Bricks"; break;
-        case 99: result = "Huge Brown Mushroom"; break;
-        case 100: result = "Huge Red Mushroom"; break;
-        case 101: result = "Iron Bars"; break;
-        case 102: result = "Glass Pane"; break;
-        case 103: result = "Melon"; break;
-        case 104: result = "Pumpkin Stem"; break;
-        case 105: result = "Melon Stem"; break;
-        case 106: result = "Vines"; break;
-        case 107: result = "Fence Gate"; break;
-        case 108: result = "Brick Stairs"; break;
-        case 109: result = "Stone Brick Stairs"; break;
-        case 110: result = "Mycelium"; break;
-        case 111: result = "Lily Pad"; break;
-        case 112: result = "Nether Brick"; break;
-        case 113: result = "Nether Brick Fence"; break;
-        case 114: result = "Nether Brick Stairs"; break;
-        case 115: result = "Nether Wart"; break;
-        case 116: result = "Enchantment Table"; break;
-        case 117: result = "Brewing Stand"; break;
-        case 118: result = "Cauldron"; break;
-        case 119: result = "End Portal"; break;
-        case 120: result = "End Portal Frame"; break;
-        case 121: result = "End Stone"; break;
-        case 122: result = "Dragon Egg"; break;
-        case 123: result = "Redstone Lamp Off"; break;
-        case 124: result = "Redstone Lamp On"; break;
-        case 125: result = "Wooden Double Slab"; break;
-        case 126: result = "Wooden Slab"; break;
-        case 127: result = "Cocoa Plant"; break;
-        case 128: result = "Sandstone Stairs"; break;
-        case 129: result = "Emerald Ore"; break;
-        case 130: result = "Ender Chest"; break;
-        case 131: result = "Tripwire Hook"; break;
-        case 132: result = "Tripwire"; break;
-        case 133: result = "Block of Emerald"; break;
-        case 134: result = "Spruce Wood Stairs"; break;
-        case 135: result = "Birch Wood Stairs"; break;
-        case 136: result = "Jungle Wood Stairs"; break;
-        case 137: result = "Command Block"; break;
-        case 138: result = "Beacon Block"; break;
-        case 139: result = "Cobblestone Wall"; break;
-        case 140: result = "Flower Pot"; break;
-        case 141: result = "Carrots"; break;
-        case 142: result = "Potatoes"; break;
-        case 143: result = "Wooden Button "; break;
-        
-        case 256: result = "Iron shovel"; break;
-        case 257: result = "Iron pickaxe"; break;
-        case 258: result = "Iron axe"; break;
-        case 259: result = "Flint and steel"; break;
-        case 260: result = "Apple"; break;
-        case 261: result = "Bow"; break;
-        case 262: result = "Arrow"; break;
-        case 263: result = "Coal"; break;
-        case 264: result = "Diamond"; break;
-        case 265: result = "Iron ingot"; break;
-        case 266: result = "Gold ingot"; break;
-        case 267: result = "Iron sword"; break;
-        case 268: result = "Wooden sword"; break;
-        case 269: result = "Wooden shovel"; break;
-        case 270: result = "Wooden pickaxe"; break;
-        case 271: result = "Wooden axe"; break;
-        case 272: result = "Stone sword"; break;
-        case 273: result = "Stone shovel"; break;
-        case 274: result = "Stone pickaxe"; break;
-        case 275: result = "Stone axe"; break;
-        case 276: result = "Diamond sword"; break;
-        case 277: result = "Diamond shovel"; break;
-        case 278: result = "Diamond pickaxe"; break;
-        case 279: result = "Diamond axe"; break;
-        case 280: result = "Stick"; break;
-        case 281: result = "Bowl"; break;
-        case 282: result = "Mushroom soup"; break;
-        case 283: result = "Gold sword"; break;
-        case 284: result = "Gold shovel"; break;
-        case 285: result = "Gold pickaxe"; break;
-        case 286: result = "Gold axe"; break;
-        case 287: result = "String"; break;
-        case 288: result = "Feather"; break;
-        case 289: result = "Sulphur"; break;
-        case 290: result = "Wooden hoe"; break;
-        case 291: result = "Stone hoe"; break;
-        case 292: result = "Iron hoe"; break;
-        case 293: result = "Diamond hoe"; break;
-        case 294: result = "Gold hoe"; break;
-        case 295: result = "Seeds"; break;
-        case 296: result = "Wheat"; break;
-        case 297: result = "Bread"; break;
-        case 298: result = "Leather helmet"; break;
-        case 299: result = "Leather tunic"; break;
-        case 300: result = "Leather leggings"; break;
-        case 301: result = "Leather boots"; break;
-        case 302: result = "Chainmail helmet"; break;
-        case 303: result = "Chainmail tunic"; break;
-        case 304: result = "Chainmail leggings"; break;
-        case 305: result = "Chainmail boots"; break;
-        case 306: result = "Iron helmet"; break;
-        case 307: result = "Iron mail"; break;
-        case 308: result = "Iron leggings"; break;
-        case 309: result = "Iron boots"; break;
-        case 310: result = "Diamond helmet"; break;
-        case 311: result = "Diamond mail"; break;
-        case 312: result = "Diamond leggings"; break;
-        case 313: result = "Diamond boots"; break;
-        case 314: result = "Gold helmet"; break;
-        case 315: result = "Gold chestplate"; break;
-        case 316: result = "Gold leggings"; break;
-        case 317: result = "Gold boots"; break;
-        case 318: result = "Flint"; break;
-        case 319: result = "Raw porkchop"; break;
-        case 320: result = "Cooked porkchop"; break;
-        case 321: result = "Paintings"; break;
-        case 322: result = "Golden apple"; break;
-        case 323: result = "Sign"; break;
-        case 324: result = "Wooden door"; break;
-        case 325: result = "Bucket"; break;
-        case 326: result = "Water bucket"; break;
-        case 327: result = "Lava bucket"; break;
-        case 328: result = "Mine cart"; break;
-        case 329: result = "Saddle"; break;
-        case 330: result = "Iron door"; break;
-        case 331: result = "Redstone"; break;
-        case 332: result = "Snowball"; break;
-        case 333: result = "Boat"; break;
-        case 334: result = "Leather"; break;
-        case 335: result = "Milk"; break;
-        case 336: result = "Clay brick"; break;
-        case 337: result = "Clay balls"; break;
-        case 338: result = "Reed"; break;
-        case 339: result = "Paper"; break;
-        case 340: result = "Book"; break;
-        case 341: result = "Slimeball"; break;
-        case 342: result = "Storage cart"; break;
-        case 343: result = "Powered cart"; break;
-        case 344: result = "Egg"; break;
-        case 345: result = "Compass"; break;
-        case 346: result = "Fishing rod"; break;
-        case 347: result = "Clock"; break;
-        case 348: result = "Glowstone dust"; break;
-        case 349: result = "Raw fish"; break;
-        case 350: result = "Cooked fish"; break;
-        case 351: 
-            //Offset should have been 1520!
-            result = "Dye"; break;
-            break;
-        case 352: result = "Bone"; break;
-        case 353: result = "Sugar"; break;
-        case 354: result = "Cake"; break;
-        case 355: result = "Bed"; break;
-        case 356: result = "Diode"; break;
-        case 357: result = "Cookie"; break;
-        case 358: result = "Map"; break;
-        case 359: result = "Shears"; break;
-        case 360: result = "Melon Slice"; break;
-	    case 361: result = "Pumpkin Seeds"; break;
-	    case 362: result = "Melon Seeds"; break;
-	    case 363: result = "Raw Beef"; break;
-	    case 364: result = "Steak"; break;
-	    case 365: result = "Raw Chicken"; break;
-	    case 366: result = "Cooked Chicken"; break;
-	    case 367: result = "Rotten Flesh"; break;
-	    case 368: result = "Ender Pearl"; break;
-	    case 369: result = "Blaze Rod"; break;
-	    case 370: result = "Ghast Tear"; break;
-	    case 371: result = "Gold Nugget"; break;
-	    case 372: result = "Nether Wart"; break;
-	    case 373: result = "Potions D"; break;
-	    case 374: result = "Glass Bottle"; break;
-	    case 375: result = "Spider Eye"; break;
-	    case 376: result = "Fermented Spider Eye"; break;
-	    case 377: result = "Blaze Powder"; break;
-	    case 378: result = "Magma Cream"; break;
-	    case 379: result = "Brewing Stand"; break;
-	    case 380: result = "Cauldron"; break;
-	    case 381: result = "Eye of Ender"; break;
-	    case 382: result = "Glistering Melon"; break;
-	    case 383: result = "Spawn Egg D"; break;
-	    case 384: result = "Bottle o' Enchanting"; break;
-	    case 385: result = "Fire Charge"; break;
-	    case 386: result = "Book and Quill"; break;
-	    case 387: result = "Written Book"; break;
-	    case 388: result = "Emerald"; break;
-	    case 389: result = "Item Frame"; break;
-	    case 390: result = "Flower Pot"; break;
-	    case 391: result = "Carrots"; break;
-	    case 392: result = "Potato"; break;
-	    case 393: result = "Baked Potato"; break;
-	    case 394: result = "Poisonous Potato"; break;
-	    case 395: result = "Map"; break;
-	    case 396: result = "Golden Carrot"; break;
-        case 397: result = "Record"; break; //Not really in the game ;)
-        
-        //Mad hax time: (("Item ID" - 256) * 16) + damage = fake ID
-        case 1520: result = "Ink Sack"; break;
-        case 1521: result = "Rose dye"; break;
-        case 1522: result = "Cactus dye"; break;
-        case 1523: result = "Cocoa dye"; break;
-        case 1524: result = "Lapis dye"; break;
-        case 1525: result = "Purple dye"; break;
-        case 1526: result = "Cyan dye"; break;
-        case 1527: result = "Light gray dye"; break;
-        case 1528: result = "Gray dye"; break;
-        case 1529: result = "Pink dye"; break;
-        case 1530: result = "Lime dye"; break;
-        case 1531: result = "Yellow dye"; break;
-        case 1532: result = "Light Blue dye"; break;
-        case 1533: result = "Magenta dye"; break;
-        case 1534: result = "Orange dye"; break;
-        case 1535: result = "Bone meal"; break;
-        
-        case 2256: result = "13 Disc"; break;
-        case 2257: result = "Cat Disc"; break;
-        case 2258: result = "blocks Disc"; break;
-	    case 2259: result = "chirp Disc"; break;
-	    case 2260: result = "far Disc"; break;
-	    case 2261: result = "mall Disc"; break;
-	    case 2262: result = "mellohi Disc"; break;
-	    case 2263: result = "stal Disc"; break;
-	    case 2264: result = "strad Disc"; break;
-	    case 2265: result = "ward Disc"; break;
-	    case 2266: result = "11 Disc"; break;
-        default:
-            result="Unknown";
-            break;
+    for (size_t i = 0; i < sizeof(nameRuns)/sizeof(nameRuns[0]); i++) {
+        if (ID >= nameRuns[i].first &&
+            ID < nameRuns[i].first + nameRuns[i].count)
+        {
+            return nameRuns[i].names[ID - nameRuns[i].first];
+        }
     }
-    
-    return result;
+
+    return "Unknown";
 }
 
 
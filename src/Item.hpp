@@ -38,7 +38,7 @@ namespace mc__ {
             Item( uint16_t iid, uint8_t c=1, uint8_t d=0, uint32_t eid=0);
 
             //Get string for item ID
-            std::string getName() const;
+            const char* getName() const;
             
             //Max number of uses for this item (static)
             uint8_t maxUses() const;
@@ -56,7 +56,7 @@ namespace mc__ {
             //  Durability, dye type, wood type
 
             //Static functions
-            static std::string getString(uint16_t iid, uint8_t offset=0);
+            static const char* getString(uint16_t iid, uint8_t offset=0);
 
     };
 }
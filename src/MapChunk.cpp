@@ -29,18 +29,31 @@ using mc__::Block;
 #include <cstring>  //memset
 #include <assert.h>
 
+//Zlib
+#include <zlib.h>
+
 //STL
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>    //sort, unique
+#include <chrono>
+#include <utility>      //move
 using std::cerr;
 using std::cout;
 using std::endl;
 using std::hex;
 using std::dec;
 
+//Counters for all map chunks
+MapChunk::tierStats_t MapChunk::tierStats = { 0, 0, 0, 0 };
+MapChunk::dedupStats_t MapChunk::dedupStats = { 0, 0, 0, 0 };
+MapChunk::sharedBlocksMap_t MapChunk::sharedBlocksMap;
+
 //Constructor
 MapChunk::MapChunk( int32_t X, int32_t Z):
-    Chunk(15, 127, 15, X, 0, Z), flags(0)
+    Chunk(15, 127, 15, X, 0, Z), lastUsed(now()), generation(0), flags(0),
+    sharedBlocks(false), blockHash(0)
 {
     //Someone must set neighbors later
     neighbors[0] = NULL;
@@ -51,9 +64,188 @@ MapChunk::MapChunk( int32_t X, int32_t Z):
     neighbors[5] = NULL;
     
     //Default everything invisible and unblocked
+    visflags = new uint8_t[mapChunkBlockMax];
     memset( visflags, 0x2, mapChunkBlockMax);
 }
 
+//Copy neighbor pointers
+void MapChunk::copyNeighbors( const MapChunk& mc)
+{
+    for (uint8_t i = 0; i < 6; i++) {
+        neighbors[i].store(mc.neighbors[i].load());
+    }
+}
+
+//Copy blocks, visibility, and compressed data
+MapChunk::MapChunk( const MapChunk& mc):
+    Chunk(mc), lastUsed(mc.lastUsed), generation(mc.generation),
+    visflags(NULL),
+    visibleIndices(mc.visibleIndices), flags(mc.flags),
+    sharedBlocks(false), blockHash(0)
+{
+    copyNeighbors(mc);
+    if (mc.visflags != NULL) {
+        visflags = new uint8_t[mapChunkBlockMax];
+        memcpy(visflags, mc.visflags, mapChunkBlockMax);
+    }
+}
+
+//Assignment operator: copy blocks, visibility, and compressed data
+MapChunk& MapChunk::operator=( const MapChunk& mc)
+{
+    //Don't copy over myself
+    if (this == &mc) { return *this; }
+
+    releaseBlocks();
+    Chunk::operator=(mc);
+    lastUsed = mc.lastUsed;
+    generation = mc.generation;
+    copyNeighbors(mc);
+    visibleIndices = mc.visibleIndices;
+    flags = mc.flags;
+
+    delete[] visflags;
+    visflags = NULL;
+    if (mc.visflags != NULL) {
+        visflags = new uint8_t[mapChunkBlockMax];
+        memcpy(visflags, mc.visflags, mapChunkBlockMax);
+    }
+
+    return *this;
+}
+
+//Take blocks, visibility, and compressed data
+MapChunk::MapChunk( MapChunk&& mc):
+    Chunk(std::move(mc)), lastUsed(mc.lastUsed), generation(mc.generation),
+    visflags(mc.visflags), visibleIndices(std::move(mc.visibleIndices)),
+    flags(mc.flags), sharedBlocks(mc.sharedBlocks), blockHash(mc.blockHash),
+    blockOwner(std::move(mc.blockOwner))
+{
+    copyNeighbors(mc);
+    mc.visflags = NULL;
+    mc.sharedBlocks = false;
+}
+
+//Move assignment: release my data, take blocks, visibility, and
+// compressed data
+MapChunk& MapChunk::operator=( MapChunk&& mc)
+{
+    //Don't move over myself
+    if (this == &mc) { return *this; }
+
+    releaseBlocks();
+    Chunk::operator=(std::move(mc));
+    lastUsed = mc.lastUsed;
+    generation = mc.generation;
+    copyNeighbors(mc);
+    visibleIndices = std::move(mc.visibleIndices);
+    flags = mc.flags;
+    sharedBlocks = mc.sharedBlocks;
+    blockHash = mc.blockHash;
+    blockOwner = std::move(mc.blockOwner);
+    mc.sharedBlocks = false;
+
+    delete[] visflags;
+    visflags = mc.visflags;
+    mc.visflags = NULL;
+
+    return *this;
+}
+
+//Deallocate visflags, release block_array if shared
+MapChunk::~MapChunk()
+{
+    releaseBlocks();
+    delete[] visflags;
+}
+
+//Seconds on steady clock
+double MapChunk::now()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Compress blocks and visflags, release uncompressed data
+bool MapChunk::freeze()
+{
+    if (isCold()) {
+        return true;
+    }
+
+    //Packed blocks followed by visflags
+    packBlocks();
+    std::vector<uint8_t> raw(byte_length + mapChunkBlockMax);
+    memcpy(&raw[0], byte_array, byte_length);
+    memcpy(&raw[byte_length], visflags, mapChunkBlockMax);
+
+    //Compress for speed, keep only the bytes used
+    uLongf length = compressBound(raw.size());
+    std::vector<uint8_t> packed(length);
+    if (compress2(&packed[0], &length, &raw[0], raw.size(), Z_BEST_SPEED)
+        != Z_OK)
+    {
+        cerr << "Unable to freeze map chunk @ " << X << "," << Z << endl;
+        return false;
+    }
+    copyZip(length, &packed[0]);
+
+    //Release everything rebuilt by thaw
+    releaseBlocks();
+    deleteByteArray();
+    delete[] visflags;
+    visflags = NULL;
+    indexList_t().swap(visibleIndices);
+    isUnzipped = false;
+
+    tierStats.frozen++;
+    return true;
+}
+
+//Uncompress cold chunk, mark chunk used
+bool MapChunk::thaw()
+{
+    lastUsed = now();
+    if (!isCold()) {
+        return true;
+    }
+
+    //Packed blocks followed by visflags
+    std::vector<uint8_t> raw(byte_length + mapChunkBlockMax);
+    uLongf length = raw.size();
+    if (uncompress(&raw[0], &length, zipped, zipped_length) != Z_OK ||
+        length != raw.size())
+    {
+        cerr << "Unable to thaw map chunk @ " << X << "," << Z << endl;
+        return false;
+    }
+    allocByteArray();
+    memcpy(byte_array, &raw[0], byte_length);
+    unpackBlocks(true);
+    visflags = new uint8_t[mapChunkBlockMax];
+    memcpy(visflags, &raw[byte_length], mapChunkBlockMax);
+    deleteZipArray();
+    zipped_length = 0;
+    isUnzipped = true;
+    shareBlocks();
+
+    //Visible blocks are the ones visflags says are visible
+    for (uint32_t index = 0; index < mapChunkBlockMax; index++) {
+        if ( (visflags[index]&0x2) != 0x2 && (visflags[index] & 0xFC) != 0xFC ) {
+            visibleIndices.insert(index);
+        }
+    }
+
+    //Time to thaw
+    double ms = (now() - lastUsed)*1000;
+    tierStats.thawed++;
+    tierStats.thaw_ms += ms;
+    if (ms > tierStats.thaw_max_ms) {
+        tierStats.thaw_max_ms = ms;
+    }
+    return true;
+}
+
 //Add chunk, update visibility
 bool MapChunk::addChunk( const Chunk *chunk)
 {
@@ -91,8 +283,19 @@ bool MapChunk::addChunk( const Chunk *chunk)
         //The person adding chunk should have dissected it
     }
 
+    //Server resent blocks we already have: nothing to recalculate
+    thaw();
+    if ((flags & LOADED) &&
+        sameBlocks(chunk, in_x, in_y, in_z, max_x, max_y, max_z))
+    {
+        dedupStats.resends_skipped++;
+        return true;
+    }
+
     //Get changes in the chunk range, and flag neighbors as updated
+    unshareBlocks();
     updateVisRange(chunk, in_x, in_y, in_z, max_x, max_y, max_z);
+    generation++;
 
     return true;
 }
@@ -100,10 +303,183 @@ bool MapChunk::addChunk( const Chunk *chunk)
 //update the visflags without a new chunk
 bool MapChunk::recalcVis()
 {
+    thaw();
     return updateVisRange(NULL, 0, 0, 0, 15, 127, 15);
     
 }
 
+//Bytes used by this map chunk, by component
+MapChunk::memory_t MapChunk::getMemory() const
+{
+    memory_t result;
+    result.object = sizeof(MapChunk);
+    result.visflags = (visflags != NULL ? mapChunkBlockMax : 0);
+    result.blocks = (block_array != NULL ? array_length*sizeof(Block) : 0);
+    if (blockOwner) {
+        //Shared array is split between everyone using it
+        result.blocks /= blockOwner.use_count();
+    }
+    result.packed = (byte_array != NULL ? byte_length : 0);
+    result.zipped = (zipped != NULL ? zipped_length : 0);
+
+    //Hash set: bucket pointers, and one node (next pointer, padded index)
+    // per index
+    result.visible = visibleIndices.bucket_count()*sizeof(void*) +
+        visibleIndices.size()*2*sizeof(void*);
+
+    result.total = result.object + result.visflags + result.blocks +
+        result.packed + result.zipped + result.visible;
+    return result;
+}
+
+//Share block_array with an identical map chunk, or offer it for sharing
+bool MapChunk::shareBlocks()
+{
+    if (sharedBlocks) {
+        return true;
+    }
+    if (block_array == NULL) {
+        return false;
+    }
+    uint64_t hash = hashBlocks();
+
+    //Array offered under this hash, if anyone still has it
+    std::shared_ptr<Block> other;
+    sharedBlocksMap_t::iterator iter = sharedBlocksMap.find(hash);
+    if (iter != sharedBlocksMap.end()) {
+        other = iter->second.lock();
+    }
+
+    if (!other) {
+        //First map chunk with these blocks
+        publishBlocks();
+        sharedBlocksMap[hash] = blockOwner;
+        dedupStats.shared_misses++;
+    } else if (other == blockOwner) {
+        //Already offered
+    } else if (memcmp(other.get(), block_array, array_length*sizeof(Block))
+        == 0)
+    {
+        //Same blocks, use the shared array
+        releaseBlocks();
+        blockOwner = other;
+        block_array = other.get();
+        dedupStats.shared_hits++;
+    } else {
+        //Different blocks with the same hash, keep my own
+        return false;
+    }
+
+    blockHash = hash;
+    sharedBlocks = true;
+    return true;
+}
+
+//Reference to block_array for readers on other threads
+std::shared_ptr<const Block> MapChunk::getSharedBlocks()
+{
+    publishBlocks();
+    return blockOwner;
+}
+
+//Move block_array to blockOwner
+void MapChunk::publishBlocks()
+{
+    if (!blockOwner && block_array != NULL) {
+        blockOwner.reset(block_array, std::default_delete<Block[]>());
+    }
+}
+
+//Stop offering block_array for sharing
+void MapChunk::unpoolBlocks()
+{
+    if (!sharedBlocks) {
+        return;
+    }
+    sharedBlocksMap_t::iterator iter = sharedBlocksMap.find(blockHash);
+    if (iter != sharedBlocksMap.end() &&
+        iter->second.lock() == blockOwner)
+    {
+        sharedBlocksMap.erase(iter);
+    }
+    sharedBlocks = false;
+}
+
+//Own a private block_array before changing it
+void MapChunk::unshareBlocks()
+{
+    if (!blockOwner) {
+        return;
+    }
+    if (blockOwner.use_count() > 1) {
+        //Others still use it, change a copy
+        Block *blocks = new Block[array_length];
+        memcpy(blocks, block_array, array_length*sizeof(Block));
+        sharedBlocks = false;
+        blockOwner.reset();
+        block_array = blocks;
+        dedupStats.unshared++;
+    } else {
+        //Only user, change it in place but don't offer it any more
+        unpoolBlocks();
+    }
+}
+
+//Give up block_array (shared or not)
+void MapChunk::releaseBlocks()
+{
+    if (!blockOwner) {
+        deleteBlockArray();
+        return;
+    }
+    if (blockOwner.use_count() > 1) {
+        sharedBlocks = false;
+    } else {
+        unpoolBlocks();
+    }
+    blockOwner.reset();
+    block_array = NULL;
+}
+
+//FNV-1a over 64 bit words of block_array
+uint64_t MapChunk::hashBlocks() const
+{
+    const uint8_t *bytes = (const uint8_t*)block_array;
+    size_t length = array_length*sizeof(Block);
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t word;
+    for (size_t i = 0; i + sizeof(word) <= length; i += sizeof(word)) {
+        memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+
+    //High bits of each word only reach high bits of hash, fold them down
+    return hash ^ (hash >> 32);
+}
+
+//True if chunk has the same blocks as this map chunk in the range
+bool MapChunk::sameBlocks(const Chunk *chunk,
+    uint8_t off_x, uint8_t off_y, uint8_t off_z,
+    uint8_t max_x, uint8_t max_y, uint8_t max_z) const
+{
+    //Same order as updateVisRange
+    uint16_t c_index=0;
+    for (uint16_t x_ = off_x; x_ <= max_x; x_++) {
+    for (uint16_t z_ = off_z; z_ <= max_z; z_++) {
+    for (uint16_t y_ = off_y; y_ <= max_y; y_++, c_index++) {
+        const Block& mine = block_array[(x_<<11)|(z_<<7)|y_];
+        const Block& theirs = chunk->block_array[c_index];
+        if (mine.blockID != theirs.blockID ||
+            mine.metadata != theirs.metadata ||
+            mine.lighting != theirs.lighting)
+        {
+            return false;
+        }
+    }}}
+    return true;
+}
+
 //Update the visflags for a range of blocks in the mapchunk
 bool MapChunk::updateVisRange(const Chunk *chunk,
     uint8_t off_x, uint8_t off_y, uint8_t off_z,
@@ -122,8 +498,8 @@ bool MapChunk::updateVisRange(const Chunk *chunk,
     //internal chunk index
     uint16_t index;
     
-    //List of changes
-    indexList_t changes;
+    //List of changes (may repeat an index)
+    indexVector_t changes;
     
     // 3D range: x_ to max_x, z_ to max_z, y_ to max_y
     //For X...
@@ -173,9 +549,91 @@ bool MapChunk::updateVisRange(const Chunk *chunk,
     }}}
 
     //Check updated blocks for visibility, update visibleIndices
-    indexList_t::const_iterator iter;
+    updateVisible(changes);
+
+    if (changes.size() > 0) {
+        flags |= MapChunk::UPDATED;
+    }
+
+    return true;
+}
+
+//Apply block changes, recalculate visibility of changed blocks once
+size_t MapChunk::setBlocks(const blockChange_t* changes, size_t count)
+{
+    if (changes == NULL) {
+        return 0;
+    }
+    size_t result=0;
+    thaw();
+
+    //Indices where block ID changed (visibility must be recalculated)
+    indexVector_t touched;
+    touched.reserve(count);
+
+    //Write the blocks
+    for (size_t i = 0; i < count; i++) {
+        const blockChange_t& change = changes[i];
+        uint16_t x_ = (change.coord >> 12) & 0x0F;
+        uint16_t z_ = (change.coord >> 8) & 0x0F;
+        uint16_t y_ = change.coord & 0x7F;
+        uint16_t index = (x_<<11)|(z_<<7)|y_;
+
+        if (block_array[index].blockID == change.blockID &&
+            block_array[index].metadata == change.metadata)
+        {
+            continue;
+        }
+        unshareBlocks();
+        Block& block = block_array[index];
+        if (block.blockID != change.blockID) {
+            touched.push_back(index);
+        }
+        block.blockID = change.blockID;
+        block.metadata = change.metadata;
+        result++;
+    }
+
+    //Same block may be changed more than once, only the last one counts
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    //Update visflags of each changed block and its neighbors
+    indexVector_t visChanges;
+    visChanges.reserve(touched.size()*7);
+    bool adj_N[6];
+    indexVector_t::const_iterator iter;
+    for (iter = touched.begin(); iter != touched.end(); iter++) {
+        uint16_t index = *iter;
+        uint16_t x_ = index >> 11;
+        uint16_t z_ = (index >> 7) & 0x0F;
+        uint16_t y_ = index & 0x7F;
+        adj_N[0] = (x_ == 0);
+        adj_N[1] = (x_ == 15);
+        adj_N[2] = (y_ == 0);
+        adj_N[3] = (y_ == 127);
+        adj_N[4] = (z_ == 0);
+        adj_N[5] = (z_ == 15);
+
+        updateVisFlags(index, adj_N, visChanges);
+    }
+    updateVisible(visChanges);
+
+    //Redraw once for all the changes (metadata changes the model too)
+    if (result > 0) {
+        flags |= MapChunk::UPDATED;
+        generation++;
+    }
+
+    return result;
+}
+
+//Add visible changed indices to visibleIndices, remove the rest
+void MapChunk::updateVisible(const indexVector_t& changes)
+{
+    indexVector_t::const_iterator iter;
     for (iter = changes.begin(); iter != changes.end(); iter++) {
-        index = *iter;
+        uint16_t index = *iter;
 
         //Is it visible?
         if ( (visflags[index]&0x2) != 0x2 && (visflags[index] & 0xFC) != 0xFC ) {
@@ -185,19 +643,13 @@ bool MapChunk::updateVisRange(const Chunk *chunk,
             visibleIndices.erase(index);
         }
     }
-
-    if (changes.size() > 0) {
-        flags |= MapChunk::UPDATED;
-    }
-
-    return true;
 }
 
 
 //update local and neighbor visflags array for opacity at x,y,z
 //Return true if changes were made to neighbor outside of MapChunk
 bool MapChunk::updateVisFlags( uint16_t index, bool adj_N[6],
-                                indexList_t& changes)
+                                indexVector_t& changes)
 {
     bool result=false;
 
@@ -279,7 +731,9 @@ bool MapChunk::updateVisFlags( uint16_t index, bool adj_N[6],
             flags_p = &(visflags[index_n]);
             flags_v = *flags_p;
             blockid_n = block_array[index_n].blockID;
-        } else if ( neighbor != NULL && (neighbor->flags & DRAWABLE)==DRAWABLE) {
+        } else if ( neighbor != NULL && (neighbor->flags & DRAWABLE)==DRAWABLE
+            && (!neighbor->isCold() || neighbor->thaw()))
+        {
             //Index inside neighbor
             flags_p = (neighbor->visflags + index_n);
             flags_v = *flags_p;
@@ -353,14 +807,14 @@ bool MapChunk::updateVisFlags( uint16_t index, bool adj_N[6],
                 }
             } else {
                 //Change inside this mapchunk
-                changes.insert(index_n);
+                changes.push_back(index_n);
             }
         }
     }
 
     //Mark change if I changed
     if (my_flags != visflags[index] ) {
-        changes.insert(index);
+        changes.push_back(index);
         visflags[index] = my_flags;
     }
 
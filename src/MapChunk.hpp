@@ -26,7 +26,11 @@
 #include "Chunk.hpp"
 
 //STL
-
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
 
 namespace mc__ {
 
@@ -37,13 +41,53 @@ namespace mc__ {
             //index = y|(z << 7)|(x << 11)   Size_Y=127, Size_Z=15
             static const uint16_t mapChunkBlockMax = (1<<(4+7+4));  //32K blocks
 
+            //Bytes used by each part of a map chunk
+            typedef struct {
+                size_t object;      //MapChunk
+                size_t visflags;    //visflags array
+                size_t blocks;      //block_array
+                size_t packed;      //byte_array
+                size_t zipped;      //compressed copy
+                size_t visible;     //visibleIndices (estimated)
+                size_t total;
+            } memory_t;
+
+            //Cold chunk statistics: chunks frozen and thawed, thaw time
+            typedef struct {
+                size_t frozen, thawed;
+                double thaw_ms, thaw_max_ms;
+            } tierStats_t;
+
+            //Duplicate data counters: resent chunks skipped, block arrays
+            // shared with an identical map chunk (hit) or offered for
+            // sharing (miss), and shared arrays copied before a change
+            typedef struct {
+                size_t resends_skipped;
+                size_t shared_hits, shared_misses, unshared;
+            } dedupStats_t;
+
+            //Block change, coord packed as x<<12 | z<<8 | y (like server)
+            typedef struct {
+                uint16_t coord;
+                uint8_t blockID, metadata;
+            } blockChange_t;
+
             //Calculate space and set X,0,Z
             //  Actual size is 16x128x16
             //  ID, metadata, and lighting are set to 0
             MapChunk(int32_t x, int32_t z);
             
-            //Deallocate chunk space
-            //~MapChunk();
+            //Copy blocks, visibility, and compressed data
+            MapChunk( const MapChunk& mc);
+            MapChunk& operator=( const MapChunk& mc);
+
+            //Take blocks, visibility, and compressed data, mc is left empty
+            MapChunk( MapChunk&& mc);
+            MapChunk& operator=( MapChunk&& mc);
+
+            //Deallocate visflags, release shared block_array (Chunk frees
+            // the rest)
+            ~MapChunk();
 
             //Update with (mini)-chunk
             bool addChunk( const mc__::Chunk *update);
@@ -51,12 +95,53 @@ namespace mc__ {
             //Recalculate visibility for all blocks
             bool recalcVis();
 
+            //Bytes used by this map chunk, by component
+            memory_t getMemory() const;
+
+            //Apply block changes, then recalculate visibility once for the
+            // changed blocks and their neighbors.  Returns blocks changed.
+            size_t setBlocks(const blockChange_t* changes, size_t count);
+
+            //Cold chunk: blocks and visflags compressed to zipped, and
+            // block_array, byte_array, visflags, visibleIndices released
+            bool isCold() const { return !isUnzipped; };
+            bool freeze();
+
+            //Uncompress cold chunk, mark chunk used.  Call before reading or
+            // changing blocks of a chunk that may be cold.
+            bool thaw();
+
+            //Seconds on steady clock when chunk was last thawed or changed
+            double lastUsed;
+            static double now();
+
+            //Incremented each time blocks change
+            uint64_t generation;
+
+            //Counters for all map chunks
+            static tierStats_t getTierStats() { return tierStats; };
+
+            //Share block_array with identical map chunks until one of them
+            // changes it (false if not shared).  Main thread only.
+            bool shareBlocks();
+            static dedupStats_t getDedupStats() { return dedupStats; };
+
+            //Reference to block_array for readers on other threads.  Blocks
+            // are copied before the next change while it is held, so the
+            // reference never changes.  NULL if chunk is cold.
+            std::shared_ptr<const mc__::Block> getSharedBlocks();
+
+            //Someone else uses block_array too
+            bool isShared() const { return (blockOwner.use_count() > 1); };
+
             //Neighbors: Adjacent map chunks on -X, +X, -Y, +Y, -Z, +Z
-            mc__::MapChunk *neighbors[6];
+            //  Other threads may load them while holding an Epoch::Guard.
+            std::atomic<mc__::MapChunk*> neighbors[6];
             
             //8 bits: [ A | B | C | D | E | F | invisible | self ] (1=opaque)
             // IF A BIT IS SET, THAT FACE IS NOT DRAWN
-            uint8_t visflags[mapChunkBlockMax];
+            // mapChunkBlockMax bytes, NULL while chunk is cold
+            uint8_t *visflags;
             
             //Ordered list of block indices to draw
             indexList_t visibleIndices;
@@ -69,10 +154,55 @@ namespace mc__ {
                 ADJ_UPDATED=0x8};
             uint32_t flags;
         protected:
-            bool updateVisFlags(uint16_t i, bool adj[6], indexList_t& changes);
+            //Block indices changed by a visibility update
+            typedef std::vector<uint16_t> indexVector_t;
+
+            bool updateVisFlags(uint16_t i, bool adj[6], indexVector_t& changes);
             bool updateVisRange(const mc__::Chunk *chunk,
                 uint8_t off_x, uint8_t off_y, uint8_t off_z,
                 uint8_t max_x, uint8_t max_y, uint8_t max_z);
+
+            //Add or remove changed indices from visibleIndices
+            void updateVisible(const indexVector_t& changes);
+
+            //Copy neighbor pointers
+            void copyNeighbors( const MapChunk& mc);
+
+            //Counters for all map chunks
+            static tierStats_t tierStats;
+            static dedupStats_t dedupStats;
+
+            //Block arrays offered for sharing by content hash
+            typedef std::unordered_map< uint64_t, std::weak_ptr<mc__::Block> >
+                sharedBlocksMap_t;
+            static sharedBlocksMap_t sharedBlocksMap;
+
+            //block_array is in sharedBlocksMap under blockHash
+            bool sharedBlocks;
+            uint64_t blockHash;
+
+            //Owns block_array once it is shared (NULL while Chunk owns it)
+            std::shared_ptr<mc__::Block> blockOwner;
+
+            //Move block_array to blockOwner
+            void publishBlocks();
+
+            //Stop offering block_array for sharing
+            void unpoolBlocks();
+
+            //Own a private block_array before changing it
+            void unshareBlocks();
+
+            //Give up block_array (shared or not)
+            void releaseBlocks();
+
+            //Hash of block_array contents
+            uint64_t hashBlocks() const;
+
+            //True if chunk has the same blocks as this map chunk
+            bool sameBlocks(const mc__::Chunk *chunk,
+                uint8_t off_x, uint8_t off_y, uint8_t off_z,
+                uint8_t max_x, uint8_t max_y, uint8_t max_z) const;
     };
 }
 
@@ -26,6 +26,7 @@ using mc__::Entity;
 using mc__::Item;
 using mc__::World;
 using mc__::Mobiles;
+using mc__::EntityStore;
 
 //STL
 #include <iostream>
@@ -45,6 +46,20 @@ Mobiles::Mobiles( mc__::World& w ): world(w), uniqueEID(1)
 Mobiles::~Mobiles()
 {
     //Free memory for all players, entities, and items
+    playerMap_t::iterator pl_iter;
+    for (pl_iter = playerMap.begin(); pl_iter != playerMap.end(); pl_iter++) {
+        delete pl_iter->second;
+    }
+    itemMap_t::iterator item_iter;
+    for (item_iter = itemMap.begin(); item_iter != itemMap.end(); item_iter++) {
+        delete item_iter->second;
+    }
+    entityMap_t::iterator ent_iter;
+    for (ent_iter = entityMap.begin(); ent_iter != entityMap.end();
+        ent_iter++)
+    {
+        delete ent_iter->second;
+    }
 }
 
 //Add named entity (a player) to mobiles in the world
@@ -76,6 +91,8 @@ Player* Mobiles::addPlayer(uint32_t eid, const std::string& name,
     //Set entity properites of the new player
     player->setPosLook( (double)X/32.0, (double)Y/32.0, (double)Z/32.0,
         height, yaw * 360.0f/255.0f, pitch * 360.0f/255.0f);
+    store.add(eid, EntityStore::KIND_PLAYER, 0, player, X, Y, Z,
+        player->yaw, player->pitch);
 
     return player;
 }
@@ -114,6 +131,8 @@ Item* Mobiles::addItem(uint32_t eid, uint16_t itemID, uint8_t count,
     item->abs_Z = Z/32.0;
     item->yaw = yaw * 360.0f/255.0f;
     item->pitch = pitch * 360.0f/255.0f;
+    store.add(eid, EntityStore::KIND_ITEM, 0, item, X, Y, Z,
+        item->yaw, item->pitch);
     
     return item;
 }
@@ -153,6 +172,8 @@ Entity* Mobiles::addEntity(uint32_t eid, uint8_t type_id,
     //Copy other values
     entity->typeID = type_id;
     entity->hitpoints = 0;
+    store.add(eid, EntityStore::KIND_ENTITY, type_id, entity,
+        entity->X, entity->Y, entity->Z, entity->yaw, entity->pitch);
     
     return entity;
 }
@@ -168,9 +189,12 @@ Player* Mobiles::findPlayer(uint32_t eid)
         player = new Player(eid, "UNKNOWN");
         //Keep track of the player by entity ID
         playerMap.insert( playerMap_t::value_type(eid, player));
+        store.add(eid, EntityStore::KIND_PLAYER, 0, player,
+            player->X, player->Y, player->Z, player->yaw, player->pitch);
         cerr << "ERROR! Unknown player entity ID " << eid << endl;
     } else {
         player = iter->second;
+        syncEntity(eid);
     }
     return player;
 }
@@ -185,9 +209,12 @@ Item* Mobiles::findItem(uint32_t eid)
         item = new Item(eid);
         //Keep track of the player by entity ID
         itemMap.insert( itemMap_t::value_type(eid, item));
+        store.add(eid, EntityStore::KIND_ITEM, 0, item,
+            item->X, item->Y, item->Z, item->yaw, item->pitch);
         cerr << "ERROR! Unknown item entity ID " << eid << endl;
     } else {
         item = iter->second;
+        syncEntity(eid);
     }
     
     return item;
@@ -202,11 +229,15 @@ Entity* Mobiles::findEntity(uint32_t eid)
     entityMap_t::const_iterator iter = entityMap.find( eid );
     if ( iter == entityMap.end()) {
         entity = new Entity(eid);
+        entity->typeID = 0;
         //Keep track of the player by entity ID
         entityMap.insert( entityMap_t::value_type(eid, entity));
+        store.add(eid, EntityStore::KIND_ENTITY, 0, entity,
+            entity->X, entity->Y, entity->Z, entity->yaw, entity->pitch);
         cerr << "ERROR! Unknown entity ID " << eid << endl;
     } else {
         entity = iter->second;
+        syncEntity(eid);
     }
     
     return entity;
@@ -226,70 +257,131 @@ void Mobiles::setPlayerEquip(uint32_t eid, uint16_t slot, uint16_t item)
 //Entity changed position
 void Mobiles::movePlayer( uint32_t eid, int8_t dX, int8_t dY, int8_t dZ)
 {
-    //Lookup player pointer
-    Player* player = findPlayer(eid);
+    //Lookup player slot, create UNKNOWN player if needed
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        findPlayer(eid);
+        slot = store.find(eid);
+    }
         
-    //Set entity properites of the new player
-    player->move( dX, dY, dZ);
+    //Set entity properites of the player
+    store.move(slot, dX, dY, dZ);
     
 }
 
 //Entity position updated
 void Mobiles::moveEntity( uint32_t eid, int8_t dX, int8_t dY, int8_t dZ)
 {
-    //Lookup player pointer
-    Entity* entity = findEntity(eid);
+    //Lookup entity slot, create UNKNOWN entity if needed
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        findEntity(eid);
+        slot = store.find(eid);
+    }
         
-    //Set entity properites of the new player
-    entity->move( dX, dY, dZ);
+    //Set entity properites
+    store.move(slot, dX, dY, dZ);
+}
+
+//Relative moves and looks received in one network tick
+void Mobiles::moveEntities( const EntityStore::move_t* moves, size_t count)
+{
+    //One snapshot time for the whole tick
+    double seconds = EntityStore::now();
+    std::vector<size_t> unknown;
+    store.applyMoves(moves, count, &unknown, seconds);
+    
+    //Create entities we did not know about, then move them
+    std::vector<size_t>::const_iterator iter;
+    for (iter = unknown.begin(); iter != unknown.end(); iter++) {
+        const EntityStore::move_t& m = moves[*iter];
+        findEntity(m.eid);
+        uint32_t slot = store.find(m.eid);
+        store.move(slot, m.dX, m.dY, m.dZ, seconds);
+        store.look(slot, m.dYaw, m.dPitch, seconds);
+    }
 }
 
 //Player changed direction
 void Mobiles::turnPlayer( uint32_t eid,  int8_t dYaw, int8_t dPitch)
 {
-    //Lookup player pointer
-    Player* player = findPlayer(eid);
+    //Lookup player slot, create UNKNOWN player if needed
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        findPlayer(eid);
+        slot = store.find(eid);
+    }
         
     //Update player direction
-    player->look( dYaw, dPitch);
+    store.look(slot, dYaw, dPitch);
 }
 
 //Update entity direction
 void Mobiles::turnEntity( uint32_t eid,  int8_t dYaw, int8_t dPitch)
 {
-    //Lookup entity pointer
-    Entity* entity = findEntity(eid);
+    //Lookup entity slot, create UNKNOWN entity if needed
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        findEntity(eid);
+        slot = store.find(eid);
+    }
         
-    //Update player direction
-    entity->look( dYaw, dPitch);
+    //Update entity direction
+    store.look(slot, dYaw, dPitch);
 }
 
 //Get entity pointer for EID (null if not found)
 mc__::Entity* Mobiles::getEntity(uint32_t eid)
 {
-    Entity* entity = NULL;
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        //NOT FOUND
+        return NULL;
+    }
     
-    //Look for animal/monster, return if found
-    entityMap_t::const_iterator ent_iter = entityMap.find( eid );
-    if ( ent_iter != entityMap.end()) {
-        entity = ent_iter->second;
-        return entity;
+    syncEntity(eid);
+    return store.object[slot];
+}
+
+//Take writes to the entity object into the store, then copy the store to it
+void Mobiles::syncEntity(uint32_t eid)
+{
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        return;
     }
     
-    //Look for player, return if found
-    playerMap_t::const_iterator pl_iter = playerMap.find( eid );
-    if ( pl_iter != playerMap.end()) {
-        entity = pl_iter->second;
-        return entity;
+    store.sync(slot);
+}
+
+//Entity was destroyed, free it and its store slot (false if not found)
+bool Mobiles::removeEntity(uint32_t eid)
+{
+    uint32_t slot = store.find(eid);
+    if (slot == EntityStore::npos) {
+        return false;
     }
     
-    //Look for item, return if found
-    itemMap_t::const_iterator item_iter = itemMap.find( eid );
-    if ( item_iter != itemMap.end()) {
-        entity = item_iter->second;
-        return entity;
+    //Free entity from map for its kind (Entity has no virtual destructor)
+    switch (store.kind[slot]) {
+        case EntityStore::KIND_PLAYER:
+            delete static_cast<Player*>(store.object[slot]);
+            playerMap.erase(eid);
+            break;
+        case EntityStore::KIND_ITEM:
+            delete static_cast<Item*>(store.object[slot]);
+            itemMap.erase(eid);
+            break;
+        case EntityStore::KIND_ENTITY:
+            delete store.object[slot];
+            entityMap.erase(eid);
+            break;
+        default:
+            break;
     }
     
-    //NOT FOUND
-    return NULL;
+    //Recycle slot
+    store.remove(eid);
+    
+    return true;
 }
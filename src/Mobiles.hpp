@@ -26,6 +26,7 @@
 #include "Player.hpp"
 #include "Item.hpp"
 #include "Entity.hpp"
+#include "EntityStore.hpp"
 
 #include "World.hpp"
 
@@ -67,13 +68,30 @@ namespace mc__ {
                 int32_t X, int32_t Y, int32_t Z,
                 uint8_t yaw=0, uint8_t pitch=0 );
             
+            //Entity was destroyed (GAME_DESTROY_ENTITY), free it and its
+            // store slot (false if not found)
+            bool removeEntity(uint32_t eid);
+            
             //Set a players visible equipment
             void setPlayerEquip(uint32_t eid, uint16_t slot, uint16_t item);
 
-            //Entity changed position
+            //Entity changed position (updates store, entity object is
+            // updated by getEntity or find*).  The store owns position and
+            // direction: writes to an entity object (setPosLook, abs_X, yaw)
+            // are taken into the store by the next getEntity or find*.
             void movePlayer( uint32_t eid, int8_t dX, int8_t dY, int8_t dZ);
             void moveEntity( uint32_t eid, int8_t dX, int8_t dY, int8_t dZ);
             
+            //Relative moves and looks received in one network tick
+            //  (unknown EIDs are created as UNKNOWN entities)
+            void moveEntities( const mc__::EntityStore::move_t* moves,
+                size_t count);
+            
+            //Update draw positions of all entities, call once per frame
+            void interpolate(double seconds=mc__::EntityStore::now()) {
+                store.interpolate(seconds);
+            };
+            
             //Entity changed direction
             void turnPlayer( uint32_t eid, int8_t dYaw, int8_t dPitch);
             void turnEntity( uint32_t eid, int8_t dYaw, int8_t dPitch);
@@ -94,7 +112,14 @@ namespace mc__ {
             itemMap_t itemMap;        //EID -> Item*
             entityMap_t entityMap;    //EID -> Entity*
             
+            //Positions and directions of all of the above, by slot
+            mc__::EntityStore store;
+            
         protected:
+            //Take writes to the entity object into the store, then copy the
+            // store to the object
+            void syncEntity(uint32_t eid);
+
             mc__::World& world; //World info
             
             uint32_t uniqueEID;  //Unique ID for entity IDs
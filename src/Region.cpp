@@ -0,0 +1,213 @@
+/*
+  mc__::Region
+    File of compressed map chunks for a 32x32 chunk area, read through a
+    memory mapping
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "Region.hpp"
+using mc__::Region;
+
+//Platform memory mapping
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+//C
+#include <cstring>  //memcmp
+
+//STL
+#include <iostream>
+#include <fstream>
+using std::cerr;
+using std::endl;
+using std::ofstream;
+using std::ios;
+using std::string;
+
+//Static const definitions
+const uint8_t Region::region_SHIFT;
+const uint16_t Region::region_CHUNKS;
+const uint32_t Region::region_VERSION;
+const uint32_t Region::header_LENGTH;
+
+//Region file magic number
+static const char region_MAGIC[4] = { 'M', 'C', 'R', 'G' };
+
+//Write little endian uint32 to file
+static void write32(ofstream& file, uint32_t value)
+{
+    char bytes[4] = { (char)(value & 0xFF), (char)((value >> 8) & 0xFF),
+        (char)((value >> 16) & 0xFF), (char)((value >> 24) & 0xFF) };
+    file.write(bytes, 4);
+}
+
+//Constructor
+Region::Region(): mapped(NULL), mappedLength(0),
+#ifdef _WIN32
+    file(INVALID_HANDLE_VALUE), mapping(NULL)
+#else
+    file(-1)
+#endif
+{
+}
+
+//Destructor
+Region::~Region()
+{
+    close();
+}
+
+//Map region file for reading
+bool Region::open(const string& filename)
+{
+    close();
+
+#ifdef _WIN32
+    file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < header_LENGTH) {
+        close();
+        return false;
+    }
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        return false;
+    }
+    mapped = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    mappedLength = (size_t)size.QuadPart;
+#else
+    file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < (off_t)header_LENGTH) {
+        close();
+        return false;
+    }
+    void *view = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    if (view != MAP_FAILED) {
+        mapped = (const uint8_t*)view;
+        mappedLength = info.st_size;
+    }
+#endif
+
+    //Check header
+    if (mapped == NULL || memcmp(mapped, region_MAGIC, 4) != 0 ||
+        read32(4) != region_VERSION)
+    {
+        cerr << "Invalid region file " << filename << endl;
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+//Unmap file
+void Region::close()
+{
+#ifdef _WIN32
+    if (mapped != NULL) { UnmapViewOfFile(mapped); }
+    if (mapping != NULL) { CloseHandle(mapping); }
+    if (file != INVALID_HANDLE_VALUE) { CloseHandle(file); }
+    mapping = NULL;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (mapped != NULL) { munmap((void*)mapped, mappedLength); }
+    if (file >= 0) { ::close(file); }
+    file = -1;
+#endif
+    mapped = NULL;
+    mappedLength = 0;
+}
+
+//Compressed data of map chunk containing block X,Z
+bool Region::getChunk(int32_t X, int32_t Z,
+    const uint8_t*& data, uint32_t& length) const
+{
+    if (mapped == NULL) {
+        return false;
+    }
+
+    //Offset table entry
+    size_t entry = 8 + getSlot(X, Z)*8;
+    uint32_t offset = read32(entry);
+    length = read32(entry + 4);
+
+    //Missing or outside of file
+    if (length == 0 || offset < header_LENGTH ||
+        (size_t)offset + length > mappedLength)
+    {
+        return false;
+    }
+
+    data = mapped + offset;
+    return true;
+}
+
+//Write region file with compressed data for each slot
+bool Region::write(const string& filename,
+    const uint8_t* const data[], const uint32_t length[])
+{
+    ofstream file( filename.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!file.good()) {
+        cerr << "Unable to write region file " << filename << endl;
+        return false;
+    }
+
+    //Header and offset table
+    file.write(region_MAGIC, 4);
+    write32(file, region_VERSION);
+    uint32_t offset = header_LENGTH;
+    for (uint16_t slot = 0; slot < region_CHUNKS; slot++) {
+        uint32_t size = (data[slot] != NULL ? length[slot] : 0);
+        write32(file, (size > 0 ? offset : 0));
+        write32(file, size);
+        offset += size;
+    }
+
+    //Chunk data in slot order
+    for (uint16_t slot = 0; slot < region_CHUNKS; slot++) {
+        if (data[slot] != NULL && length[slot] > 0) {
+            file.write((const char*)data[slot], length[slot]);
+        }
+    }
+
+    return file.good();
+}
+
+//Read little endian uint32 from mapped file
+uint32_t Region::read32(size_t offset) const
+{
+    const uint8_t *p = mapped + offset;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
@@ -0,0 +1,98 @@
+/*
+  mc__::Region
+    File of compressed map chunks for a 32x32 chunk area, read through a
+    memory mapping
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__REGION_H
+#define MC__REGION_H
+
+//STL
+#include <string>
+#include <cstddef>
+
+//Compiler specific options
+#ifdef _MSC_VER
+    #include "ms_stdint.h"
+#else
+    #include <stdint.h>
+#endif
+
+namespace mc__ {
+
+    //Region file layout (integers are little endian):
+    //  "MCRG", uint32 version
+    //  region_CHUNKS x { uint32 offset, uint32 length }  (length 0 = none)
+    //  zlib compressed packed blocks of each 16x128x16 map chunk
+    class Region {
+        public:
+            //Region is 32x32 map chunks (512x512 blocks)
+            static const uint8_t region_SHIFT = 9;
+            static const uint16_t region_CHUNKS = 32*32;
+            static const uint32_t region_VERSION = 1;
+            static const uint32_t header_LENGTH = 8 + region_CHUNKS*8;
+
+            //Constructor, no file mapped
+            Region();
+
+            //Unmap file
+            ~Region();
+
+            //Map region file for reading (false if missing or invalid)
+            bool open(const std::string& filename);
+            void close();
+            bool isOpen() const { return (mapped != NULL); };
+
+            //Compressed data of map chunk containing block X,Z
+            //  Points into mapped file, false if chunk is not in region.
+            bool getChunk(int32_t X, int32_t Z,
+                const uint8_t*& data, uint32_t& length) const;
+
+            //Write region file with compressed data for each slot
+            static bool write(const std::string& filename,
+                const uint8_t* const data[], const uint32_t length[]);
+
+            //Slot in region of map chunk containing block X,Z
+            static uint16_t getSlot(int32_t X, int32_t Z) {
+                return ((X >> 4) & 0x1F) | (((Z >> 4) & 0x1F) << 5);
+            };
+
+        protected:
+            //Read little endian uint32 from mapped file
+            uint32_t read32(size_t offset) const;
+
+            //Mapped file contents
+            const uint8_t *mapped;
+            size_t mappedLength;
+
+            //Platform file and mapping handles
+#ifdef _WIN32
+            void *file, *mapping;
+#else
+            int file;
+#endif
+
+        private:
+            //Mapping can't be copied
+            Region( const Region& r);
+            Region& operator=( const Region& r);
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+/*
+  mc__::Snapshot
+    Read-only view of the map at one moment, for other threads
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "Snapshot.hpp"
+#include "MapChunk.hpp"
+using mc__::Snapshot;
+using mc__::Block;
+using mc__::Chunk;
+using mc__::MapChunk;
+
+//Zlib
+#include <zlib.h>
+
+//C
+#include <cstring>  //memcpy
+
+//STL
+#include <iostream>
+using std::cerr;
+using std::endl;
+using std::vector;
+
+//Map chunk containing block X,Z
+const Snapshot::chunk_t* Snapshot::getChunk(int32_t X, int32_t Z) const
+{
+    chunkMap_t::const_iterator iter = chunks.find(getKey(X, Z));
+    if (iter == chunks.end()) {
+        return NULL;
+    }
+    return &(iter->second);
+}
+
+//Blocks of map chunk containing block X,Z
+const Block* Snapshot::getBlocks(int32_t X, int32_t Z,
+    vector<Block>& scratch) const
+{
+    const chunk_t* chunk = getChunk(X, Z);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    if (chunk->blocks) {
+        return chunk->blocks.get();
+    }
+
+    //Cold map chunk: packed blocks followed by visflags (MapChunk::freeze)
+    Chunk unpacked(15, 127, 15, chunk->X, 0, chunk->Z, false);
+    vector<uint8_t> raw(unpacked.byte_length + MapChunk::mapChunkBlockMax);
+    uLongf length = raw.size();
+    if (chunk->zipped.empty() ||
+        uncompress(&raw[0], &length, &chunk->zipped[0], chunk->zipped.size())
+            != Z_OK || length != raw.size())
+    {
+        cerr << "Unable to read snapshot chunk @ " << chunk->X << ","
+            << chunk->Z << endl;
+        return NULL;
+    }
+    unpacked.allocByteArray();
+    memcpy(unpacked.byte_array, &raw[0], unpacked.byte_length);
+    unpacked.unpackBlocks(true);
+    scratch.assign(unpacked.block_array,
+        unpacked.block_array + unpacked.array_length);
+    return &scratch[0];
+}
+
+//Copy of block at X,Y,Z
+Block Snapshot::getBlock(int32_t X, int8_t Y, int32_t Z) const
+{
+    //Return "air" if not found.
+    Block result = {0, 0, 0, 0};
+
+    vector<Block> scratch;
+    const Block* blocks = getBlocks(X, Z, scratch);
+    if (blocks != NULL && Y >= 0) {
+        uint16_t index = ((X&0xF)<<11)|((Z&0xF)<<7)|(Y&0x7F);
+        result = blocks[index];
+    }
+
+    return result;
+}
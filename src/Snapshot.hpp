@@ -0,0 +1,81 @@
+/*
+  mc__::Snapshot
+    Read-only view of the map at one moment, for other threads
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__SNAPSHOT_H
+#define MC__SNAPSHOT_H
+
+//mc--
+#include "Chunk.hpp"     //includes "Block.hpp"
+
+//STL
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mc__ {
+
+    //Block arrays are shared with the map chunks that had them when the
+    // snapshot was taken.  A map chunk copies its blocks before changing
+    // them while a snapshot holds them, so a snapshot never changes and
+    // any thread may read it.
+    class Snapshot {
+        public:
+            //One 16x128x16 map chunk, indexed like MapChunk
+            typedef struct {
+                int32_t X, Z;
+                uint64_t generation;                    //MapChunk::generation
+                std::shared_ptr<const mc__::Block> blocks;  //NULL if cold
+                std::vector<uint8_t> zipped;            //cold map chunk data
+            } chunk_t;
+
+            //Empty snapshot
+            Snapshot(): generation(0) {};
+
+            //Map chunk containing block X,Z (NULL if none)
+            const chunk_t* getChunk(int32_t X, int32_t Z) const;
+
+            //Blocks of map chunk containing block X,Z.  Cold map chunks are
+            // uncompressed to scratch.  NULL if none.
+            const mc__::Block* getBlocks(int32_t X, int32_t Z,
+                std::vector<mc__::Block>& scratch) const;
+
+            //Copy of block at X,Y,Z (air if none)
+            mc__::Block getBlock(int32_t X, int8_t Y, int32_t Z) const;
+
+            //Map chunks in snapshot
+            size_t size() const { return chunks.size(); };
+
+            //Incremented for each snapshot of a World
+            uint64_t generation;
+
+            //Map chunks by key of X,Z
+            typedef std::unordered_map< uint64_t, chunk_t > chunkMap_t;
+            chunkMap_t chunks;
+
+            //Key of map chunk containing block X,Z
+            static uint64_t getKey(int32_t X, int32_t Z) {
+                return ((uint64_t)(uint32_t)(X & 0xFFFFFFF0) << 32) |
+                    (uint32_t)(Z & 0xFFFFFFF0);
+            };
+    };
+}
+
+#endif
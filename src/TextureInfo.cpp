@@ -23,23 +23,6 @@
 
 using mc__::TextureInfo;
 
-//Constructor
-TextureInfo::TextureInfo( tex_t tt, GLfloat tx0, GLfloat tx1,
-            GLfloat ty0, GLfloat ty1):
-                texType(tt), tx_0(tx0), tx_1(tx1), ty_0(ty0), ty_1(ty1)
-{
-}
-
-//Other constructor
-TextureInfo::TextureInfo( tex_t tt, GLsizei max_width, GLsizei max_height,
-            GLsizei x0, GLsizei y0, GLsizei tex_width, GLsizei tex_height):
-                texType(tt)
-{
-    //Calculate values
-    setTexCoords(max_width, max_height, x0, y0, tex_width, tex_height,
-        tx_0, tx_1, ty_0, ty_1);
-}
-
 void TextureInfo::getCoords( GLfloat& tx0, GLfloat& tx1,
     GLfloat& ty0, GLfloat& ty1) const
 {
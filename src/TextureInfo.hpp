@@ -25,6 +25,13 @@
 //OpenGL
 #include <GL/gl.h>
 
+//Compiler specific options
+#ifdef _MSC_VER
+    #include "ms_stdint.h"
+#else
+    #include <stdint.h>
+#endif
+
 
 namespace mc__ {
 
@@ -35,11 +42,25 @@ namespace mc__ {
     class TextureInfo {
       public:
       
-        //Constructors
-        TextureInfo( tex_t tt, GLfloat tx0, GLfloat tx1,
-            GLfloat ty0, GLfloat ty1);
-        TextureInfo( tex_t tt, GLsizei max_width, GLsizei max_height,
-            GLsizei x0, GLsizei y0, GLsizei tex_width, GLsizei tex_height);
+        //Constructors (constexpr, so tables of them need no setup)
+        constexpr TextureInfo( tex_t tt, GLfloat tx0, GLfloat tx1,
+            GLfloat ty0, GLfloat ty1):
+                texType(tt), tx_0(tx0), tx_1(tx1), ty_0(ty0), ty_1(ty1) {};
+        constexpr TextureInfo( tex_t tt, GLsizei max_width, GLsizei max_height,
+            GLsizei x0, GLsizei y0, GLsizei tex_width, GLsizei tex_height):
+                texType(tt),
+                tx_0(max_width ? x0/GLfloat(max_width) : 0),
+                tx_1(max_width ? (x0 + tex_width)/GLfloat(max_width) : 0),
+                ty_0(max_height ? y0/GLfloat(max_height) : 0),
+                ty_1(max_height ? (y0 + tex_height)/GLfloat(max_height) : 0)
+                {};
+
+        //Tile of a 16x16 tile texture map (terrain.png, items.png)
+        static constexpr TextureInfo tile( tex_t tt, uint8_t index) {
+            return TextureInfo( tt, (index & 0x0F)/16.0f,
+                (index & 0x0F)/16.0f + 1/16.0f, (index >> 4)/16.0f,
+                (index >> 4)/16.0f + 1/16.0f);
+        };
         
         //Get values
         void getCoords( GLfloat& tx0, GLfloat& tx1,
@@ -148,4 +169,4 @@ namespace mc__ {
 }
 
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+/*
+  mc__::ThreadPool
+    Worker threads that split a loop of independent tasks
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+//mc--
+#include "ThreadPool.hpp"
+using mc__::ThreadPool;
+
+//Start threads-1 workers
+ThreadPool::ThreadPool(size_t threads): task(NULL), count(0), next(0),
+    job(0), busy(0), stopping(false)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    for (size_t i = 1; i < threads; i++) {
+        workers.push_back(std::thread(&ThreadPool::work, this));
+    }
+}
+
+//Stop workers
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    std::vector<std::thread>::iterator iter;
+    for (iter = workers.begin(); iter != workers.end(); iter++) {
+        iter->join();
+    }
+}
+
+//Call task(i) for i in 0 to count-1 on all threads
+void ThreadPool::run(size_t n, const task_t& t)
+{
+    //Start the workers
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        task = &t;
+        count = n;
+        next = 0;
+        busy = workers.size();
+        job++;
+    }
+    wake.notify_all();
+
+    //Help, then wait for the rest
+    runTasks();
+    std::unique_lock<std::mutex> guard(lock);
+    while (busy > 0) {
+        done.wait(guard);
+    }
+    task = NULL;
+}
+
+//Worker thread loop: run each job until stopped
+void ThreadPool::work()
+{
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        while (job == seen && !stopping) {
+            wake.wait(guard);
+        }
+        if (stopping) {
+            return;
+        }
+        seen = job;
+
+        guard.unlock();
+        runTasks();
+        guard.lock();
+
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+//Take tasks until none are left
+void ThreadPool::runTasks()
+{
+    size_t i;
+    while ((i = next.fetch_add(1)) < count) {
+        (*task)(i);
+    }
+}
@@ -0,0 +1,92 @@
+/*
+  mc__::ThreadPool
+    Worker threads that split a loop of independent tasks
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MC__THREADPOOL_H
+#define MC__THREADPOOL_H
+
+//STL
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Compiler specific options
+#ifdef _MSC_VER
+    #include "ms_stdint.h"
+#else
+    #include <stdint.h>
+#endif
+
+namespace mc__ {
+
+    //The calling thread works too, so a pool of size 1 has no workers
+    class ThreadPool {
+        public:
+            //Task number 0 to count-1
+            typedef std::function<void(size_t)> task_t;
+
+            //Start threads-1 workers (0 = one per core)
+            ThreadPool(size_t threads=0);
+
+            //Stop workers
+            ~ThreadPool();
+
+            //Threads used by run, including the caller
+            size_t size() const { return workers.size() + 1; };
+
+            //Call task(i) for i in 0 to count-1 on all threads, return when
+            // every call is done
+            void run(size_t count, const task_t& task);
+
+        protected:
+            std::vector<std::thread> workers;
+
+            //Current loop
+            const task_t *task;
+            size_t count;
+            std::atomic<size_t> next;
+
+            //Loop number, workers still in it, and stop request
+            uint64_t job;
+            size_t busy;
+            bool stopping;
+
+            //Guards job, busy, stopping
+            std::mutex lock;
+            std::condition_variable wake, done;
+
+            //Worker thread loop
+            void work();
+
+            //Take tasks until none are left
+            void runTasks();
+
+        private:
+            //Threads can't be copied
+            ThreadPool( const ThreadPool& p);
+            ThreadPool& operator=( const ThreadPool& p);
+    };
+}
+
+#endif
@@ -64,9 +64,13 @@ using mc__::Viewer;
 using mc__::face_ID;
 using mc__::World;
 using mc__::MapChunk;
+using mc__::layer_t;
+using mc__::EntityStore;
 
 //C
 #include <cmath>    //fmod
+#include <cstdlib>  //abs
+#include <cstring>  //memset
 
 //More STL
 #include <iostream>
@@ -74,6 +78,8 @@ using mc__::MapChunk;
 #include <fstream>
 #include <sstream>
 #include <set>
+#include <algorithm>
+#include <functional>   //bind
 
 using std::cout;
 using std::cerr;
@@ -94,7 +100,12 @@ using std::stringstream;
 
 using std::set;
 
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::milli;
+
 const float Viewer::PI = std::atan(1.0)*4;
+const size_t Viewer::item_PREWARM_PER_FRAME;
 
 
 //Library version info
@@ -109,6 +120,27 @@ Viewer::Viewer(World* w, unsigned short width, unsigned short height):
     item_rotation(0),
     use_mipmaps(true), use_blending(false), debugging(false)
 {
+    //No frames drawn yet
+    memset(&frameStats, 0, sizeof(frameStats));
+    memset(timerQueries, 0, sizeof(timerQueries));
+    memset(timerStarted, 0, sizeof(timerStarted));
+    statsHistoryMax = 600;
+    
+    //No translucent blocks sorted yet
+    translucentChanged = false;
+    translucentChunks = 0;
+    translucentList = 0;
+    sortCam[0] = sortCam[1] = sortCam[2] = 0;
+    resortDistance = 1.0;
+    
+    //Default item limits
+    itemDistance = 64.0;
+    itemLimit = 1024;
+    
+    //Item models are compiled when first drawn
+    memset(itemModels, 0, sizeof(itemModels));
+    memset(itemModelUsed, 0, sizeof(itemModelUsed));
+    itemModelLimit = 256;
   
     //TODO: depends on mapchunk biome setting
     //Dark green tree leaves
@@ -123,6 +155,23 @@ Viewer::Viewer(World* w, unsigned short width, unsigned short height):
     grass_color[2] = 0x1F;    //Blue
     grass_color[3] = 0xFF;    //Opaque
 
+    //Draw map chunks with less detail 8 and 16 map chunks away
+    lodDistance[0] = 8;
+    lodDistance[1] = 16;
+
+    //Free GL lists of map chunks the world evicts
+    if (world != NULL) {
+        world->setEvictHandler(
+            std::bind(&Viewer::freeMapChunk, this, std::placeholders::_1));
+    }
+}
+
+//Stop world from notifying this viewer
+Viewer::~Viewer()
+{
+    if (world != NULL) {
+        world->setEvictHandler(mc__::evictHandler_t());
+    }
 }
 
 //Start up OpenGL
@@ -207,7 +256,7 @@ bool Viewer::init(
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
-    //Generate the ITEM, ENTITY, and PLAYER display lists
+    //Item information (models are compiled when first drawn)
     loadItemInfo();
 
     return result;
@@ -305,6 +354,43 @@ void Viewer::setDrawDistance( GLdouble d)
     gluPerspective(fieldOfViewY, aspectRatio, 1.0f, d);
 }
 
+//Set map chunk distance for 2x2x2 and 4x4x4 cells (0 to disable)
+void Viewer::setLODDistance( uint16_t lod2, uint16_t lod4)
+{
+    lodDistance[0] = lod2;
+    lodDistance[1] = lod4;
+}
+
+//Camera distance in blocks before translucent blocks are resorted
+void Viewer::setResortDistance( GLfloat blocks)
+{
+    resortDistance = blocks;
+}
+
+//Only draw items within distance (blocks), nearest limit items (0 = all)
+void Viewer::setItemLimits( GLfloat distance, size_t limit)
+{
+    itemDistance = distance;
+    itemLimit = limit;
+}
+
+//Keep at most count item models compiled (0 = no limit)
+void Viewer::setItemModelLimit( size_t count)
+{
+    itemModelLimit = count;
+    while (itemModelLimit != 0 && itemModelIDs.size() > itemModelLimit) {
+        if (!evictItemModel()) {
+            break;
+        }
+    }
+}
+
+//Compile models for item IDs before they are first drawn
+void Viewer::prewarmItemModels( const std::vector<uint16_t>& IDs)
+{
+    itemPrewarm.insert(itemPrewarm.end(), IDs.begin(), IDs.end());
+}
+
 //Draw a dropped item that can be picked up (caller must translate to X,Y,Z)
 void Viewer::drawDroppedItem( uint16_t itemID )
 {
@@ -370,71 +456,183 @@ using mc__::chunkSet_t;
 void Viewer::drawMapChunk(MapChunk* mapchunk)
 {
     MapChunk& myChunk = *mapchunk;
+    frameStats.chunks_considered++;
 
     //Don't draw invisible or unloaded mapchunks
     if ( (myChunk.flags & MapChunk::DRAWABLE) != MapChunk::DRAWABLE ) {
         return;
     }
 
-    //If the chunk has not uncompressed it's data, do so now
-    if (! myChunk.isUnzipped) {        
-        //Debug output
-        if (debugging) {
-            cout << "Unzipping chunk @ " << (int)myChunk.X << ","
-                << (int)myChunk.Y << "," << (int)myChunk.Z << endl;
-        }
-        //Unzip the chunk
-        if (!myChunk.unzip(true)) {
-            cerr << "ERROR UNZIPPING" << endl;
-            return;
+    //Cold chunks are drawn from their compiled lists, and uncompressed only
+    // when a list has to be compiled
+    //Every compiled list is out of date if the chunk was updated
+    bool updated = ((myChunk.flags & MapChunk::UPDATED) != 0);
+    myChunk.flags &= ~(MapChunk::UPDATED);
+
+    //Far away chunks are drawn with fewer, bigger cells
+    uint8_t step = getLODStep(myChunk);
+    if (step > 1) {
+        drawMapChunkLOD(mapchunk, step, updated);
+        return;
+    }
+
+    //Reduced detail list must be recompiled next time it is used
+    if (updated) {
+        mapChunkLODMap_t::iterator iter_lod = glListMapLOD.find(mapchunk);
+        if (iter_lod != glListMapLOD.end()) {
+            iter_lod->second.step = 0;
         }
-        
-        //Requires new glList
-        myChunk.flags |= MapChunk::UPDATED;
     }
 
-    //Get gl_list associated with map chunk
+    //Get gl_lists associated with map chunk
     GLuint gl_list=0;
     mapChunkUintMap_t::const_iterator iter = glListMap.find(mapchunk);
     if (iter != glListMap.end()) {
         gl_list = iter->second;
 
-        //Draw the precompiled list (might be recalculated after)
-        glCallList(gl_list);
+        //Draw the precompiled opaque lists facing the camera (might be
+        // recalculated after).  Cutout list is drawn by drawMapChunks.
+        uint8_t facing = getFacingFlags(myChunk);
+        for (uint8_t face = 0; face <= chunk_LIST_OTHER; face++) {
+            if (face < FACE_MAX && !(facing & (0x80 >> face))) {
+                continue;
+            }
+            glCallList(gl_list + face);
+            countCalled(gl_list + face);
+        }
+        drawnChunks.push_back(mapchunk);
+        frameStats.chunks_drawn++;
 
     } else {
-        //Create new list to be calculated
-        gl_list = glGenLists(1);
+        //Create new lists to be calculated
+        gl_list = glGenLists(chunk_LISTS);
         glListMap[mapchunk] = gl_list;
-        myChunk.flags |= MapChunk::UPDATED;
+        updated = true;
     }
 
     //Compile GL list if needed (drawing to screen happens elsewhere)
-    if (myChunk.flags & MapChunk::UPDATED) {
-
-        //DEBUG updates
-        //cout << "MapChunk UPDATED flag: " << (int)myChunk.X << ","
-        //        << (int)myChunk.Y << "," << (int)myChunk.Z << endl;
-
-        //chunk vars
-        GLint X=myChunk.X>>4;   //chunk coord for far block face culling
-        GLint Y=64;
-        GLint Z=myChunk.Z>>4;   //chunk coord for far block face culling
-        indexList_t& visibleIndices = myChunk.visibleIndices;
-        indexList_t::const_iterator iter;
-
-        //Chunk coordinates to compare... remove GL coordinate and last 4 bits
-        GLint view_X = ((int)cam_X >> 8);
-        GLint view_Z = ((int)cam_Z >> 8);
-
-        //Calculate facemask to apply to visflags, based on chunk X/Z
-        //Mark faces player cannot see from their MapChunk as invisible
-        uint8_t pvflags = 0;
-        pvflags |= (X < view_X ? 0x80 : (X > view_X ? 0x40 : 0x00));
-        pvflags |= (Z < view_Z ? 0x08 : (Z > view_Z ? 0x04 : 0x00));
-                
+    if (updated) {
+        compileMapChunk(myChunk, gl_list);
+    }
+}
+
+//Delete full detail lists of map chunk, and its translucent blocks
+void Viewer::freeMapChunkLists(MapChunk* mapchunk)
+{
+    mapChunkUintMap_t::iterator iter_full = glListMap.find(mapchunk);
+    if (iter_full != glListMap.end()) {
+        glDeleteLists(iter_full->second, chunk_LISTS);
+        for (uint8_t face = 0; face < chunk_LISTS; face++) {
+            listQuads.erase(iter_full->second + face);
+        }
+        glListMap.erase(iter_full);
+    }
+    
+    if (translucentBlocks.erase(mapchunk) > 0) {
+        translucentChanged = true;
+    }
+}
+
+//Delete all GL lists of map chunk (world is evicting it)
+void Viewer::freeMapChunk(MapChunk* mapchunk)
+{
+    freeMapChunkLists(mapchunk);
+    glListMapOccluded.erase(mapchunk);
+
+    mapChunkLODMap_t::iterator iter_lod = glListMapLOD.find(mapchunk);
+    if (iter_lod != glListMapLOD.end()) {
+        glDeleteLists(iter_lod->second.list, 1);
+        listQuads.erase(iter_lod->second.list);
+        glListMapLOD.erase(iter_lod);
+    }
+
+    //Forget it in the draw order of the last frame
+    drawOrder.erase(std::remove(drawOrder.begin(), drawOrder.end(), mapchunk),
+        drawOrder.end());
+    drawnChunks.erase(std::remove(drawnChunks.begin(), drawnChunks.end(),
+        mapchunk), drawnChunks.end());
+}
+
+//Draw map chunk using reduced detail list, compile it if needed
+void Viewer::drawMapChunkLOD(MapChunk* mapchunk, uint8_t step, bool updated)
+{
+    //Full detail list is out of date, free it until it is needed again
+    if (updated) {
+        freeMapChunkLists(mapchunk);
+    }
+
+    //Get reduced detail list associated with map chunk
+    mapChunkLODMap_t::iterator iter = glListMapLOD.find(mapchunk);
+    if (iter == glListMapLOD.end()) {
+        lodList_t lod = { glGenLists(1), 0 };
+        iter = glListMapLOD.insert(
+            mapChunkLODMap_t::value_type(mapchunk, lod)).first;
+    } else if (updated) {
+        iter->second.step = 0;
+    }
+    lodList_t& lod = iter->second;
+
+    //Compile if chunk changed or cell size is different, then draw
+    if (lod.step != step) {
+        compileMapChunkLOD(*mapchunk, lod.list, step);
+        lod.step = step;
+    }
+    glCallList(lod.list);
+    countCalled(lod.list);
+    frameStats.chunks_drawn++;
+}
+
+//Compile every visible block in map chunk to chunk_LISTS GL lists:
+// opaque cube faces grouped by direction, other opaque blocks, cutout blocks.
+// Translucent blocks are kept for sorting.
+void Viewer::compileMapChunk(MapChunk& myChunk, GLuint gl_list)
+{
+    steady_clock::time_point started = steady_clock::now();
+    if (!myChunk.thaw()) {
+        return;
+    }
+
+    //DEBUG updates
+    //cout << "MapChunk UPDATED flag: " << (int)myChunk.X << ","
+    //        << (int)myChunk.Y << "," << (int)myChunk.Z << endl;
+
+    //block coordinates
+    GLint X, Y, Z;
+    indexList_t& visibleIndices = myChunk.visibleIndices;
+    indexList_t::const_iterator iter;
+    frameStats.chunks_rebuilt++;
+    
+    //Remember translucent blocks to sort them with other map chunks
+    translucentList_t translucent;
+    for (iter = visibleIndices.begin(); iter != visibleIndices.end(); iter++)
+    {
+        uint16_t index = *iter;
+        const Block& block = myChunk.block_array[index];
+        if (getLayer(block.blockID) != LAYER_TRANSLUCENT) {
+            continue;
+        }
+        translucentBlock_t tb = { myChunk.X + (index >> 11),
+            myChunk.Y + (index & 0x7F), myChunk.Z + ((index >> 7) & 0xF),
+            block, myChunk.visflags[index] };
+        translucent.push_back(tb);
+    }
+    if (!translucent.empty()) {
+        translucentBlocks[&myChunk].swap(translucent);
+        translucentChanged = true;
+    } else if (translucentBlocks.erase(&myChunk) > 0) {
+        translucentChanged = true;
+    }
+
+    for (uint8_t face = 0; face < chunk_LISTS; face++) {
+        uint32_t quads=0;
+        
+        //Only this face is drawn in face lists
+        uint8_t faceMask = (face < FACE_MAX ? 0xFC & ~(0x80 >> face) : 0);
+        layer_t layer = (face == chunk_LIST_CUTOUT ? LAYER_CUTOUT :
+            LAYER_OPAQUE);
+        
         //Start the GL_COMPILING! Don't execute, that will happen next frame
-        glNewList(gl_list, GL_COMPILE);
+        glNewList(gl_list + face, GL_COMPILE);
 
         //Rebind terrain png
         glBindTexture( GL_TEXTURE_2D, textures[mc__::TEX_TERRAIN]);
@@ -442,47 +640,236 @@ void Viewer::drawMapChunk(MapChunk* mapchunk)
         glBegin(GL_QUADS);
         
         //Draw the visible blocks
-        for (iter = visibleIndices.begin(); iter != visibleIndices.end(); iter++)
+        for (iter = visibleIndices.begin(); iter != visibleIndices.end();
+            iter++)
         {
             //When indexing block in chunk array,
             //index = y + (z << 7) + (x << 11)
             uint16_t index = *iter;
+            const Block& block = myChunk.block_array[index];
+            
+            //Base visibility flags
+            uint8_t vflags = myChunk.visflags[index] | faceMask;
+            
+            //Opaque plain cubes go in face lists, other opaque blocks in
+            // the next one, then cutout blocks
+            if (getLayer(block.blockID) != layer || (vflags & 0xFC) == 0xFC
+                || (layer == LAYER_OPAQUE &&
+                    blockDraw->isFaceCulled(block.blockID) != (face < FACE_MAX)))
+            {
+                continue;
+            }
+            
             X = myChunk.X + (index >> 11);
             Y = myChunk.Y + (index & 0x7F);
             Z = myChunk.Z + ((index >> 7) & 0xF);
             
-            //Base visibility flags
-            uint8_t vflags = myChunk.visflags[index];
-            
             //Draw the block (based on block type)
-            drawBlock(myChunk.block_array[index],X, Y, Z, vflags/*pvflags|*/);
-            //Uncomment pvflags to hide faces player can't see
+            drawBlock(block, X, Y, Z, vflags);
+            
+            //Estimate quads from faces not hidden
+            for (uint8_t faces = (~vflags & 0xFC); faces != 0;
+                faces &= faces-1)
+            {
+                quads++;
+            }
         }
         //End the list
         glEnd();
         glEndList();
-
-        //Finished drawing chunk, no longer "updated"
-        myChunk.flags &= ~(MapChunk::UPDATED);
+        
+        countCompiled(gl_list + face, quads, started);
+        started = steady_clock::now();
     }
 }
 
-//Draw all moving objects (entities)
-bool Viewer::drawMobiles(const mc__::Mobiles& mobiles)
+//Compile map chunk to GL list as step*step*step cells of one block type
+//  Cells on the map chunk border always draw their outside faces, so there
+//  are no holes where a neighbor is drawn with a different cell size.
+void Viewer::compileMapChunkLOD(MapChunk& myChunk, GLuint gl_list,
+    uint8_t step)
 {
-    itemMap_t::const_iterator item_iter;
+    steady_clock::time_point started = steady_clock::now();
+    uint32_t quads=0;
+    if (!myChunk.thaw()) {
+        return;
+    }
+    frameStats.chunks_rebuilt++;
+
+    //Cells in each dimension
+    const uint8_t cells_X = 16/step, cells_Y = 128/step, cells_Z = 16/step;
+    
+    //Representative block ID for each cell (0 = empty)
+    //  cell index = y + (z * cells_Y) + (x * cells_Y * cells_Z)
+    uint8_t cellID[8*64*8];
+    
+    //Number of times each cube block ID appears in a cell
+    uint8_t counts[256];
     
-    const itemMap_t& itemMap = mobiles.itemMap;
-    GLuint displayList;
+    uint8_t x, y, z, i, j, k;
+    uint16_t cell=0;
     
-    //Go through all items in the world that we know about
-    //  TODO: items in visible range
-    for (item_iter = itemMap.begin(); item_iter != itemMap.end(); item_iter++) {
-        //NO ERROR CHECKING HERE!  FOR GREAT JUSTICE
+    //Choose a block ID for every cell
+    for (x = 0; x < cells_X; x++) {
+    for (z = 0; z < cells_Z; z++) {
+    for (y = 0; y < cells_Y; y++, cell++) {
+        memset(counts, 0, sizeof(counts));
+        uint8_t filled=0, best=0, best_visible=0;
         
+        for (i = x*step; i < (x+1)*step; i++) {
+        for (k = z*step; k < (z+1)*step; k++) {
+        for (j = y*step; j < (y+1)*step; j++) {
+            uint16_t index = (i<<11)|(k<<7)|j;
+            uint8_t blockID = myChunk.block_array[index].blockID;
+            
+            //Only cubes are big enough to see from far away
+            if (!Blk::isCube[blockID]) {
+                continue;
+            }
+            filled++;
+            counts[blockID]++;
+            
+            //Most common block ID
+            if (counts[blockID] > counts[best]) {
+                best = blockID;
+            }
+            
+            //Most common block ID that player could see up close
+            if ( (myChunk.visflags[index] & 0x2) != 0x2 &&
+                 (myChunk.visflags[index] & 0xFC) != 0xFC &&
+                 (best_visible == 0 || counts[blockID] > counts[best_visible]))
+            {
+                best_visible = blockID;
+            }
+        }}}
+        
+        //Cell is solid if at least half of it is filled
+        if (filled*2 < step*step*step) {
+            cellID[cell] = 0;
+        } else {
+            cellID[cell] = (best_visible != 0 ? best_visible : best);
+        }
+    }}}
+
+    //Start the GL_COMPILING!
+    glNewList(gl_list, GL_COMPILE);
+    glBindTexture( GL_TEXTURE_2D, textures[mc__::TEX_TERRAIN]);
+    glBegin(GL_QUADS);
+
+    //Cell index offsets for -X, +X, -Y, +Y, -Z, +Z
+    const int offset[6] = { -(cells_Y*cells_Z), cells_Y*cells_Z,
+        -1, 1, -cells_Y, cells_Y };
+    
+    cell=0;
+    for (x = 0; x < cells_X; x++) {
+    for (z = 0; z < cells_Z; z++) {
+    for (y = 0; y < cells_Y; y++, cell++) {
+        uint8_t blockID = cellID[cell];
+        if (blockID == 0) {
+            continue;
+        }
+        
+        //Cell is on the edge of the map chunk for -X, +X, -Y, +Y, -Z, +Z
+        bool edge[6] = { x == 0, x == cells_X - 1, y == 0, y == cells_Y - 1,
+            z == 0, z == cells_Z - 1 };
+        
+        //Draw each face that is not covered by an opaque cell
+        for (i = 0; i < 6; i++) {
+            uint8_t faceMask = (0x80 >> i);
+            if (edge[i]) {
+                //Nothing under the world
+                if (i == 2) { continue; }
+            } else if (Blk::isOpaque[cellID[cell + offset[i]]]) {
+                continue;
+            }
+            
+            //Hide every other face, scale one block to cell size
+            blockDraw->setBlockColor(blockID, (face_ID)i);
+            blockDraw->drawScaledBlock(blockID, 0,
+                myChunk.X + x*step, myChunk.Y + y*step, myChunk.Z + z*step,
+                (uint8_t)(0xFC & ~faceMask), step, step, step, false);
+            quads++;
+        }
+    }}}
+
+    //Return color to normal
+    blockDraw->setBlockColor(0, (face_ID)0);
+    
+    glEnd();
+    glEndList();
+    
+    countCompiled(gl_list, quads, started);
+}
+
+//Cell size to draw map chunk with, depending on distance from camera
+uint8_t Viewer::getLODStep(const MapChunk& mapchunk) const
+{
+    //Map chunk distance from camera map chunk
+    GLint dX = (mapchunk.X >> 4) - ((int)cam_X >> 8);
+    GLint dZ = (mapchunk.Z >> 4) - ((int)cam_Z >> 8);
+    uint16_t distance = std::max( std::abs(dX), std::abs(dZ));
+    
+    uint8_t step = 1;
+    if (lodDistance[1] != 0 && distance >= lodDistance[1]) {
+        step = 4;
+    } else if (lodDistance[0] != 0 && distance >= lodDistance[0]) {
+        step = 2;
+    }
+    
+    return step;
+}
+
+//Face directions of map chunk that camera could see (visflags)
+uint8_t Viewer::getFacingFlags(const MapChunk& mapchunk) const
+{
+    //Camera position in blocks
+    GLfloat view_X = cam_X / TILE_LENGTH;
+    GLfloat view_Y = cam_Y / TILE_LENGTH;
+    GLfloat view_Z = cam_Z / TILE_LENGTH;
+    
+    //A face is seen from its front side; check the block faces nearest
+    // the camera in each direction
+    uint8_t facing = 0;
+    facing |= (view_X < mapchunk.X + mapchunk.size_X ? 0x80 : 0);
+    facing |= (view_X > mapchunk.X ? 0x40 : 0);
+    facing |= (view_Y < mapchunk.Y + mapchunk.size_Y ? 0x20 : 0);
+    facing |= (view_Y > mapchunk.Y ? 0x10 : 0);
+    facing |= (view_Z < mapchunk.Z + mapchunk.size_Z ? 0x08 : 0);
+    facing |= (view_Z > mapchunk.Z ? 0x04 : 0);
+    
+    return facing;
+}
+
+//Draw all moving objects (entities)
+bool Viewer::drawMobiles(const mc__::Mobiles& mobiles)
+{
+    steady_clock::time_point started = steady_clock::now();
+    startTimer(1);
+    
+    //Squared draw distance in GL coordinates
+    GLfloat maxDistance = itemDistance*TILE_LENGTH;
+    maxDistance *= maxDistance;
+    
+    //Go through all items in the world that we know about, keep the ones
+    // in range
+    const EntityStore& store = mobiles.store;
+    itemInstances.clear();
+    
+    //Entities near the camera (with a block of room for interpolation)
+    nearSlots.clear();
+    store.findInRadius(cam_X/TILE_LENGTH, cam_Y/TILE_LENGTH,
+        cam_Z/TILE_LENGTH, itemDistance + 1, nearSlots);
+    std::vector<uint32_t>::const_iterator slot_iter;
+    for (slot_iter = nearSlots.begin(); slot_iter != nearSlots.end();
+        slot_iter++)
+    {
+        uint32_t slot = *slot_iter;
+        if (store.kind[slot] != EntityStore::KIND_ITEM) {
+            continue;
+        }
         
         //Get display list for item
-        const Item *item = item_iter->second;
+        const Item *item = static_cast<const Item*>(store.object[slot]);
         
         //item ID might depend on "damage" field.
         uint16_t itemID = item->itemID;
@@ -490,21 +877,60 @@ bool Viewer::drawMobiles(const mc__::Mobiles& mobiles)
             itemID = itemInfo[item->itemID].dataOffset + item->hitpoints;
         }
         
-        //Draw the 
-        displayList = itemModels[ itemID ];
-
-        //Translate world to item coordinates (offset from camera)
-        drawFromCamera();
-        glTranslatef( item->X/2.0 + texmap_TILE_LENGTH/2,
-                      item->Y/2.0 + 2,
-                      item->Z/2.0 + texmap_TILE_LENGTH/2);
-        glRotatef( item->yaw + item_rotation, 0.0f, 1.0f, 0.0f);
+        //Item coordinates in GL
+        itemInstance_t instance;
+        instance.list = getItemModel( itemID );
+        instance.X = (store.draw_X[slot] + 0.5f)*TILE_LENGTH;
+        instance.Y = store.draw_Y[slot]*TILE_LENGTH + 2;
+        instance.Z = (store.draw_Z[slot] + 0.5f)*TILE_LENGTH;
+        instance.yaw = store.draw_yaw[slot];
+        
+        //Skip items too far away
+        GLfloat dX = instance.X - cam_X;
+        GLfloat dY = instance.Y - cam_Y;
+        GLfloat dZ = instance.Z - cam_Z;
+        instance.distance = dX*dX + dY*dY + dZ*dZ;
+        if (instance.distance > maxDistance) {
+            continue;
+        }
+        
+        itemInstances.push_back(instance);
+    }
+    
+    //Only draw the nearest items if there are too many
+    if (itemLimit != 0 && itemInstances.size() > itemLimit) {
+        std::nth_element(itemInstances.begin(),
+            itemInstances.begin() + itemLimit, itemInstances.end(),
+            [](const itemInstance_t& a, const itemInstance_t& b) {
+                return a.distance < b.distance;
+            });
+        itemInstances.resize(itemLimit);
+    }
+    
+    //Group items with the same model
+    std::sort(itemInstances.begin(), itemInstances.end(),
+        [](const itemInstance_t& a, const itemInstance_t& b) {
+            return a.list < b.list;
+        });
+    
+    //Translate world to camera once, then to each item
+    drawFromCamera();
+    itemInstanceList_t::const_iterator iter;
+    for (iter = itemInstances.begin(); iter != itemInstances.end(); iter++) {
+        glPushMatrix();
+        glTranslatef( iter->X, iter->Y, iter->Z);
+        glRotatef( iter->yaw + item_rotation, 0.0f, 1.0f, 0.0f);
 
         //Draw the precompiled list
-        glCallList(displayList);
-
+        glCallList(iter->list);
+        countCalled(iter->list);
+        frameStats.items_drawn++;
+        glPopMatrix();
     }
 
+    stopTimer(1);
+    frameStats.cpu_mobiles_ms +=
+        duration<double, milli>(steady_clock::now() - started).count();
     
     return true;
 }
@@ -542,14 +968,303 @@ bool Viewer::createEntityModels()
 //Draw the megachunks in mc__::World
 void Viewer::drawMapChunks( const World& world)
 {
-    //Use the mapChunkList of all map chunks to draw them
-    const mapChunkList_t& mapChunks = world.mapChunks;
+    steady_clock::time_point started = steady_clock::now();
+    startTimer(0);
+
+    //Sort all map chunks nearest first, so opaque blocks hide farther ones
+    GLfloat view_X = cam_X / TILE_LENGTH;
+    GLfloat view_Z = cam_Z / TILE_LENGTH;
+    drawOrder = world.mapChunks;
+    std::sort(drawOrder.begin(), drawOrder.end(),
+        [view_X, view_Z](const MapChunk* a, const MapChunk* b) {
+            GLfloat aX = a->X + 8 - view_X, aZ = a->Z + 8 - view_Z;
+            GLfloat bX = b->X + 8 - view_X, bZ = b->Z + 8 - view_Z;
+            return (aX*aX + aZ*aZ) < (bX*bX + bZ*bZ);
+        });
+    
+    //Opaque layer
+    drawnChunks.clear();
     mapChunkList_t::const_iterator iter;
-    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++)
+    for (iter = drawOrder.begin(); iter != drawOrder.end(); iter++)
     {
         drawMapChunk(*iter);
     }
     
+    //Cutout layer (alpha tested) of full detail map chunks
+    for (iter = drawnChunks.begin(); iter != drawnChunks.end(); iter++)
+    {
+        GLuint gl_list = glListMap[*iter] + chunk_LIST_CUTOUT;
+        glCallList(gl_list);
+        countCalled(gl_list);
+    }
+    
+    //Translucent layer, back to front
+    updateTranslucent();
+    if (translucentList != 0) {
+        if (use_blending) {
+            glEnable(GL_BLEND);
+            glDepthMask(GL_FALSE);
+        }
+        glCallList(translucentList);
+        countCalled(translucentList);
+        if (use_blending) {
+            glDepthMask(GL_TRUE);
+            glDisable(GL_BLEND);
+        }
+    }
+    
+    stopTimer(0);
+    frameStats.cpu_chunks_ms +=
+        duration<double, milli>(steady_clock::now() - started).count();
+}
+
+//Sort translucent blocks farthest from camera first
+static Viewer::translucentList_t sortBackToFront(
+    Viewer::translucentList_t blocks, GLfloat x, GLfloat y, GLfloat z)
+{
+    std::sort(blocks.begin(), blocks.end(),
+        [x, y, z](const Viewer::translucentBlock_t& a,
+            const Viewer::translucentBlock_t& b) {
+            GLfloat aX = a.X + 0.5f - x, aY = a.Y + 0.5f - y,
+                aZ = a.Z + 0.5f - z;
+            GLfloat bX = b.X + 0.5f - x, bY = b.Y + 0.5f - y,
+                bZ = b.Z + 0.5f - z;
+            return (aX*aX + aY*aY + aZ*aZ) > (bX*bX + bY*bY + bZ*bZ);
+        });
+    return blocks;
+}
+
+//Sort translucent blocks on worker thread, compile when done
+void Viewer::updateTranslucent()
+{
+    //Compile sorted blocks when worker thread is finished
+    if (translucentSort.valid() && translucentSort.wait_for(
+        std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        compileTranslucent(translucentSort.get());
+    }
+    
+    //Map chunks with translucent blocks appeared or went away: hash the
+    // set of them (sum of mixed pointers, so draw order does not matter)
+    uint64_t chunks = 0;
+    mapChunkList_t::const_iterator iter;
+    for (iter = drawnChunks.begin(); iter != drawnChunks.end(); iter++) {
+        if (translucentBlocks.count(*iter) != 0) {
+            uint64_t h = (uint64_t)(uintptr_t)*iter;
+            h = (h ^ (h >> 33))*0xFF51AFD7ED558CCDULL;
+            h = (h ^ (h >> 33))*0xC4CEB9FE1A85EC53ULL;
+            chunks += h ^ (h >> 33);
+        }
+    }
+    if (chunks != translucentChunks) {
+        translucentChanged = true;
+    }
+    
+    //Wait for running sort to finish
+    if (translucentSort.valid()) {
+        return;
+    }
+    
+    //Resort if blocks changed, or camera moved far enough
+    GLfloat view[3] = { cam_X / TILE_LENGTH, cam_Y / TILE_LENGTH,
+        cam_Z / TILE_LENGTH };
+    GLfloat dX = view[0] - sortCam[0];
+    GLfloat dY = view[1] - sortCam[1];
+    GLfloat dZ = view[2] - sortCam[2];
+    if (!translucentChanged &&
+        dX*dX + dY*dY + dZ*dZ < resortDistance*resortDistance)
+    {
+        return;
+    }
+    
+    //Copy translucent blocks of drawn map chunks for the worker thread
+    translucentList_t blocks;
+    for (iter = drawnChunks.begin(); iter != drawnChunks.end(); iter++) {
+        mapChunkTranslucentMap_t::const_iterator iter_tb =
+            translucentBlocks.find(*iter);
+        if (iter_tb != translucentBlocks.end()) {
+            blocks.insert(blocks.end(),
+                iter_tb->second.begin(), iter_tb->second.end());
+        }
+    }
+    
+    sortCam[0] = view[0]; sortCam[1] = view[1]; sortCam[2] = view[2];
+    translucentChanged = false;
+    translucentChunks = chunks;
+    translucentSort = std::async(std::launch::async, sortBackToFront,
+        std::move(blocks), view[0], view[1], view[2]);
+}
+
+//Compile sorted translucent blocks to GL list
+void Viewer::compileTranslucent(const translucentList_t& sorted)
+{
+    steady_clock::time_point started = steady_clock::now();
+    uint32_t quads=0;
+    
+    if (translucentList == 0) {
+        translucentList = glGenLists(1);
+    }
+    
+    glNewList(translucentList, GL_COMPILE);
+    glBindTexture( GL_TEXTURE_2D, textures[mc__::TEX_TERRAIN]);
+    glBegin(GL_QUADS);
+    
+    translucentList_t::const_iterator iter;
+    for (iter = sorted.begin(); iter != sorted.end(); iter++) {
+        drawBlock(iter->block, iter->X, iter->Y, iter->Z, iter->vflags);
+        
+        //Estimate quads from faces not hidden
+        for (uint8_t faces = (~iter->vflags & 0xFC); faces != 0;
+            faces &= faces-1)
+        {
+            quads++;
+        }
+    }
+    
+    glEnd();
+    glEndList();
+    
+    countCompiled(translucentList, quads, started);
+}
+
+//Which render layer a block is drawn in
+layer_t Viewer::getLayer(uint8_t blockID)
+{
+    switch (blockID) {
+        case Blk::WaterFlow:
+        case Blk::Water:
+        case Blk::Ice:
+        case Blk::Portal:
+            return LAYER_TRANSLUCENT;
+        default:
+            break;
+    }
+    
+    return (Blk::isOpaque[blockID] ? LAYER_OPAQUE : LAYER_CUTOUT);
+}
+
+//Start counting statistics for a new frame
+void Viewer::startFrame()
+{
+    uint32_t frame = frameStats.frame + 1;
+    
+    //Timer queries for this frame were last used two frames ago
+    uint8_t buffer = (frame & 1);
+    std::deque<renderStats_t>::reverse_iterator old = statsHistory.rbegin();
+    if (old != statsHistory.rend()) { old++; }
+    for (uint8_t section = 0; section < 2; section++) {
+        if (!timerStarted[buffer][section]) {
+            continue;
+        }
+        timerStarted[buffer][section] = false;
+        
+        //Fill in GPU time for that frame, if it is still kept
+#ifdef MC__GL_TIMER_QUERY
+        GLuint64 elapsed=0;
+        glGetQueryObjectui64v(timerQueries[buffer][section], GL_QUERY_RESULT,
+            &elapsed);
+        if (old != statsHistory.rend() && old->frame == frame - 2) {
+            double& gpu_ms =
+                (section == 0 ? old->gpu_chunks_ms : old->gpu_mobiles_ms);
+            gpu_ms = (gpu_ms < 0 ? 0 : gpu_ms) + elapsed/1000000.0;
+        }
+#endif
+    }
+    
+    //Reset counters
+    memset(&frameStats, 0, sizeof(frameStats));
+    frameStats.frame = frame;
+    frameStats.gpu_chunks_ms = -1;
+    frameStats.gpu_mobiles_ms = -1;
+    
+    //Compile a few prewarmed item models, without evicting any
+    size_t compiled=0;
+    while (!itemPrewarm.empty() && compiled < item_PREWARM_PER_FRAME &&
+        (itemModelLimit == 0 || itemModelIDs.size() < itemModelLimit))
+    {
+        uint16_t ID = itemPrewarm.front();
+        itemPrewarm.pop_front();
+        if (ID < item_id_MAX && itemModels[ID] == 0) {
+            createItemModel(ID);
+            itemModelUsed[ID] = frame;
+            compiled++;
+        }
+    }
+}
+
+//Keep statistics for finished frame
+void Viewer::endFrame()
+{
+    statsHistory.push_back(frameStats);
+    while (statsHistory.size() > statsHistoryMax) {
+        statsHistory.pop_front();
+    }
+}
+
+//Statistics for the last finished frame
+const Viewer::renderStats_t& Viewer::getFrameStats() const
+{
+    if (statsHistory.empty()) {
+        return frameStats;
+    }
+    return statsHistory.back();
+}
+
+//Number of frames of statistics to keep
+void Viewer::setStatsHistory(size_t frames)
+{
+    statsHistoryMax = (frames > 0 ? frames : 1);
+    while (statsHistory.size() > statsHistoryMax) {
+        statsHistory.pop_front();
+    }
+}
+
+//Add compiled display list to frame statistics
+void Viewer::countCompiled(GLuint gl_list, uint32_t quads,
+    steady_clock::time_point started)
+{
+    //Each quad is 4 vertices of (2 texture coordinates, 3 coordinates)
+    const uint32_t bytesPerQuad = 4*(2*sizeof(GLfloat) + 3*sizeof(GLint));
+    
+    listQuads[gl_list] = quads;
+    frameStats.lists_compiled++;
+    frameStats.bytes_compiled += quads*bytesPerQuad;
+    frameStats.cpu_mesh_ms +=
+        duration<double, milli>(steady_clock::now() - started).count();
+}
+
+//Add called display list to frame statistics
+void Viewer::countCalled(GLuint gl_list)
+{
+    listQuadMap_t::const_iterator iter = listQuads.find(gl_list);
+    if (iter != listQuads.end()) {
+        frameStats.quads += iter->second;
+    }
+}
+
+//Start GL timer for section (0 = map chunks, 1 = mobiles)
+void Viewer::startTimer(uint8_t section)
+{
+    uint8_t buffer = (frameStats.frame & 1);
+    if (timerQueries[buffer][section] == 0 || timerStarted[buffer][section]) {
+        return;
+    }
+#ifdef MC__GL_TIMER_QUERY
+    glBeginQuery(GL_TIME_ELAPSED, timerQueries[buffer][section]);
+#endif
+}
+
+//Stop GL timer for section
+void Viewer::stopTimer(uint8_t section)
+{
+    uint8_t buffer = (frameStats.frame & 1);
+    if (timerQueries[buffer][section] == 0 || timerStarted[buffer][section]) {
+        return;
+    }
+#ifdef MC__GL_TIMER_QUERY
+    glEndQuery(GL_TIME_ELAPSED);
+#endif
+    timerStarted[buffer][section] = true;
 }
 
 //OpenGL Set up buffer, perspective, blah blah blah
@@ -592,12 +1307,17 @@ void Viewer::startOpenGL() {
     glGenTextures(entity_type_MAX, entity_tex);
     //TODO: configureTexture for each one
     
-    //Blending setting
-    if (!use_blending) {
-        glDisable(GL_BLEND);
-    } else {
-        glEnable(GL_BLEND);
+#ifdef MC__GL_TIMER_QUERY
+    //Time drawing on the GPU, if the driver can
+    const char *extensions = (const char*)glGetString(GL_EXTENSIONS);
+    if (extensions != NULL && strstr(extensions, "GL_ARB_timer_query")) {
+        glGenQueries(4, &timerQueries[0][0]);
     }
+#endif
+    
+    //Blending setting: only enabled while drawing translucent blocks
+    glDisable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 }
 
@@ -716,8 +1436,7 @@ void Viewer::setItemInfo( uint16_t index, uint8_t A, uint8_t properties, uint16_
     iteminf.properties = properties;
     iteminf.dataOffset = offset;
 
-    //draw to openGL model
-    createItemModel(index);
+    //OpenGL model is created when the item is first drawn
     
     //createItemTexture(index);
 }
@@ -725,13 +1444,19 @@ void Viewer::setItemInfo( uint16_t index, uint8_t A, uint8_t properties, uint16_
 //Create texture and model for item
 bool Viewer::createItemModel( uint16_t index)
 {
+    steady_clock::time_point started = steady_clock::now();
     BlockInfo& iteminf = itemInfo[index];
 
     //Create display list for item model
     itemModels[index] = glGenLists(1);
+    if (itemModels[index] == 0) {
+        cerr << "Unable to create display list for item " << index << endl;
+        return false;
+    }
     glNewList(itemModels[index], GL_COMPILE);
 
     //Draw model to display list
+    uint32_t quads=0;
     switch (iteminf.properties & 0x07) {
         case 0:
             //Terrain cube (as item 75% size)
@@ -741,6 +1466,7 @@ bool Viewer::createItemModel( uint16_t index)
             blockDraw->drawScaledBlock( index&0xFF, 0/*meta*/, 0, 0, 0, 0,
                 0.25, 0.25, 0.25, false, -2, 0, -2);
             glEnd();
+            quads=6;
             break;
         case 1:
             //Terrain item (as item 75% size)
@@ -750,6 +1476,7 @@ bool Viewer::createItemModel( uint16_t index)
             blockDraw->drawScaledBlock( index&0xFF, 0/*meta*/, 0, 0, 0, 0,
                 0.25, 0.25, 0.25, false, -2, 0, -2);
             glEnd();
+            quads=6;
             break;
         case 2:     //Regular item icon :)
         case 6:     //Item icon depends on damage field, change ID at run time
@@ -758,6 +1485,7 @@ bool Viewer::createItemModel( uint16_t index)
             glBegin(GL_QUADS);
             drawDroppedItem( index);
             glEnd();
+            quads=2;
             break;
         case 3:
             //Special inventory item
@@ -765,6 +1493,7 @@ bool Viewer::createItemModel( uint16_t index)
             glBegin(GL_QUADS);
             drawDroppedItem( index);
             glEnd();
+            quads=2;
             break;
             
         default:
@@ -772,10 +1501,59 @@ bool Viewer::createItemModel( uint16_t index)
     }
     
     glEndList();
+    countCompiled(itemModels[index], quads, started);
+    itemModelIDs.push_back(index);
     
     return true;
 }
 
+//Display list for item ID, compiled on first use
+GLuint Viewer::getItemModel( uint16_t ID)
+{
+    if (ID >= item_id_MAX) {
+        return 0;
+    }
+    
+    //Make room for the new model, keep it if every model is in use
+    if (itemModels[ID] == 0) {
+        if (itemModelLimit != 0 && itemModelIDs.size() >= itemModelLimit) {
+            evictItemModel();
+        }
+        createItemModel(ID);
+    }
+    
+    itemModelUsed[ID] = frameStats.frame;
+    return itemModels[ID];
+}
+
+//Delete least recently drawn item model not drawn this frame
+bool Viewer::evictItemModel()
+{
+    size_t oldest = itemModelIDs.size();
+    for (size_t i = 0; i < itemModelIDs.size(); i++) {
+        uint32_t used = itemModelUsed[itemModelIDs[i]];
+        if (used != frameStats.frame &&
+            (oldest == itemModelIDs.size() ||
+             used < itemModelUsed[itemModelIDs[oldest]]))
+        {
+            oldest = i;
+        }
+    }
+    if (oldest == itemModelIDs.size()) {
+        return false;
+    }
+    
+    //Remove from compiled IDs without keeping order
+    uint16_t ID = itemModelIDs[oldest];
+    itemModelIDs[oldest] = itemModelIDs.back();
+    itemModelIDs.pop_back();
+    
+    glDeleteLists(itemModels[ID], 1);
+    listQuads.erase(itemModels[ID]);
+    itemModels[ID] = 0;
+    return true;
+}
+
 /*
 //Create the display lists that will be used for drawing mobiles
 bool Viewer::createItemModels()
@@ -1104,7 +1882,7 @@ bool Viewer::saveChunks(const mc__::World& world) const
     for (iter_xz = coordMapChunks.begin();
         iter_xz != coordMapChunks.end(); iter_xz++)
     {
-        Chunk *chunk = iter_xz->second;
+        MapChunk *chunk = iter_xz->second;
         X = chunk->X;
         Y = chunk->Y;
         Z = chunk->Z;
@@ -1115,7 +1893,7 @@ bool Viewer::saveChunks(const mc__::World& world) const
             << (int)X << "_" << (int)Y << "_" << (int)Z << ".bin";
         
         //Copy binary chunk data to file
-        if (chunk != NULL) {
+        if (chunk != NULL && chunk->thaw()) {
             //Pack blocks to byte_array
             chunk->packBlocks();
             writeChunkBin( chunk, filename.str());
@@ -1172,9 +1950,8 @@ bool Viewer::saveLocalBlocks(const mc__::World& world) const
         const Chunk *chunk = world.getChunk( X&0xFFFFFFF0, Z&0xFFFFFFF0);
         if (chunk != NULL)
         {
-            //Get block @ X,Y,Z
-            uint16_t index = ((X&0xF)<<11)|((Z&0xF)<<7)|(Y&0x7F);
-            mc__::Block& block = chunk->block_array[index];
+            //Get block @ X,Y,Z (uncompresses cold chunk)
+            mc__::Block block = world.getBlock(X, Y, Z);
             seenBlocks.insert(block.blockID);
             
             //Print block info
@@ -1201,6 +1978,71 @@ bool Viewer::saveLocalBlocks(const mc__::World& world) const
     return true;
 }
 
+//Write render statistics of recent frames as CSV
+bool Viewer::saveStatsCSV(const std::string& filename) const
+{
+    ofstream statsfile( filename.c_str(), ios::out);
+    if (!statsfile) {
+        cerr << "Unable to write render stats to " << filename << endl;
+        return false;
+    }
+    
+    statsfile << "frame,chunks_considered,chunks_drawn,chunks_rebuilt,"
+        << "items_drawn,quads,lists_compiled,bytes_compiled,"
+        << "cpu_chunks_ms,cpu_mobiles_ms,cpu_mesh_ms,"
+        << "gpu_chunks_ms,gpu_mobiles_ms" << endl;
+    
+    std::deque<renderStats_t>::const_iterator iter;
+    for (iter = statsHistory.begin(); iter != statsHistory.end(); iter++) {
+        const renderStats_t& stats = *iter;
+        statsfile << stats.frame << "," << stats.chunks_considered << ","
+            << stats.chunks_drawn << "," << stats.chunks_rebuilt << ","
+            << stats.items_drawn << "," << stats.quads << ","
+            << stats.lists_compiled << "," << stats.bytes_compiled << ","
+            << stats.cpu_chunks_ms << "," << stats.cpu_mobiles_ms << ","
+            << stats.cpu_mesh_ms << "," << stats.gpu_chunks_ms << ","
+            << stats.gpu_mobiles_ms << endl;
+    }
+    
+    statsfile.close();
+    return true;
+}
+
+//Write render statistics of recent frames as JSON
+bool Viewer::saveStatsJSON(const std::string& filename) const
+{
+    ofstream statsfile( filename.c_str(), ios::out);
+    if (!statsfile) {
+        cerr << "Unable to write render stats to " << filename << endl;
+        return false;
+    }
+    
+    statsfile << "[" << endl;
+    std::deque<renderStats_t>::const_iterator iter;
+    for (iter = statsHistory.begin(); iter != statsHistory.end(); iter++) {
+        const renderStats_t& stats = *iter;
+        statsfile << (iter == statsHistory.begin() ? "  {" : ", {")
+            << "\"frame\": " << stats.frame
+            << ", \"chunks_considered\": " << stats.chunks_considered
+            << ", \"chunks_drawn\": " << stats.chunks_drawn
+            << ", \"chunks_rebuilt\": " << stats.chunks_rebuilt
+            << ", \"items_drawn\": " << stats.items_drawn
+            << ", \"quads\": " << stats.quads
+            << ", \"lists_compiled\": " << stats.lists_compiled
+            << ", \"bytes_compiled\": " << stats.bytes_compiled
+            << ", \"cpu_chunks_ms\": " << stats.cpu_chunks_ms
+            << ", \"cpu_mobiles_ms\": " << stats.cpu_mobiles_ms
+            << ", \"cpu_mesh_ms\": " << stats.cpu_mesh_ms
+            << ", \"gpu_chunks_ms\": " << stats.gpu_chunks_ms
+            << ", \"gpu_mobiles_ms\": " << stats.gpu_mobiles_ms
+            << "}" << endl;
+    }
+    statsfile << "]" << endl;
+    
+    statsfile.close();
+    return true;
+}
+
 
 //List all the Map Chunks to stdout
 void Viewer::printChunks(const mc__::World& world) const
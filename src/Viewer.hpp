@@ -36,6 +36,10 @@
 //STL
 #include <string>
 #include <map>
+#include <deque>
+#include <vector>
+#include <chrono>
+#include <future>
 
 //OpenGL
 //#include <GL/glew.h>
@@ -47,17 +51,79 @@ namespace mc__ {
 
     //Library version checker in mc__ namespace
     unsigned long getVersion();
+    
+    //Render layers: solid, alpha tested, blended back to front
+    enum layer_t { LAYER_OPAQUE=0, LAYER_CUTOUT, LAYER_TRANSLUCENT };
+    
+    //GL lists per map chunk: opaque cubes per face direction, other opaque
+    // blocks, then cutout blocks.  Translucent blocks are sorted separately.
+    const uint8_t chunk_LIST_OTHER = FACE_MAX;
+    const uint8_t chunk_LIST_CUTOUT = FACE_MAX + 1;
+    const uint8_t chunk_LISTS = FACE_MAX + 2;
 
     class Viewer {
         public:
 
-            //relate MapChunk* -> GL List number
+            //relate MapChunk* -> GL List number (first of chunk_LISTS)
             typedef std::unordered_map< mc__::MapChunk*, GLuint>
                 mapChunkUintMap_t;
 
+            //Reduced detail GL list, and cell size it was compiled with
+            typedef struct {
+                GLuint list;
+                uint8_t step;   //2 or 4 blocks per cell, 0 if out of date
+            } lodList_t;
+
+            //relate MapChunk* -> reduced detail GL list
+            typedef std::unordered_map< mc__::MapChunk*, lodList_t>
+                mapChunkLODMap_t;
+
+            //relate GL list -> number of quads compiled in it
+            typedef std::unordered_map< GLuint, uint32_t> listQuadMap_t;
+
+            //Translucent block to sort, in block coordinates
+            typedef struct {
+                GLint X, Y, Z;
+                mc__::Block block;
+                uint8_t vflags;
+            } translucentBlock_t;
+            typedef std::vector<translucentBlock_t> translucentList_t;
+
+            //relate MapChunk* -> translucent blocks in it
+            typedef std::unordered_map< mc__::MapChunk*, translucentList_t>
+                mapChunkTranslucentMap_t;
+            
+            //Item to draw this frame, in GL coordinates
+            typedef struct {
+                GLuint list;
+                GLfloat X, Y, Z, yaw;
+                GLfloat distance;   //squared, from camera
+            } itemInstance_t;
+            typedef std::vector<itemInstance_t> itemInstanceList_t;
+
+            //Drawing statistics for one frame (between startFrame/endFrame)
+            typedef struct {
+                uint32_t frame;             //Frame number
+                uint32_t chunks_considered; //drawMapChunk calls
+                uint32_t chunks_drawn;      //Map chunk lists called
+                uint32_t chunks_rebuilt;    //Map chunk lists compiled
+                uint32_t items_drawn;       //Item lists called
+                uint32_t quads;             //Quads in all lists called
+                uint32_t lists_compiled;    //Display lists compiled
+                uint32_t bytes_compiled;    //Vertex data sent to lists
+                double cpu_chunks_ms;       //drawMapChunks (includes mesh)
+                double cpu_mobiles_ms;      //drawMobiles
+                double cpu_mesh_ms;         //Compiling map chunk lists
+                double gpu_chunks_ms;       //GL time, -1 if not available
+                double gpu_mobiles_ms;      //GL time, -1 if not available
+            } renderStats_t;
+
             //Constructor
             Viewer( World* w,
                 unsigned short width, unsigned short height);
+
+            //Stop world from notifying this viewer
+            ~Viewer();
             
             //Map item ID to item information
             BlockInfo itemInfo[item_id_MAX];
@@ -104,14 +170,35 @@ namespace mc__ {
             //Draw a 16x128x16 chunk, unmark "UPDATED" flag
             void drawMapChunk(mc__::MapChunk* mc);
             
-            //Draw all the mapchunks
+            //Draw a far away chunk with 2x2x2 or 4x4x4 block cells
+            void drawMapChunkLOD(mc__::MapChunk* mc, uint8_t step,
+                bool updated);
+            
+            //Draw all the mapchunks: opaque front to back, then cutout,
+            // then translucent back to front
             void drawMapChunks( const mc__::World& world);
             
             //Draw all terrain and placed blocks
             bool drawWorld(const mc__::World& world);
             
-            //Draw all moving objects (entities)
+            //Draw all moving objects (entities) at their interpolated
+            // positions (call Mobiles::interpolate first)
             bool drawMobiles(const mc__::Mobiles& mobiles);
+            
+            //Frame statistics: call before and after drawing each frame
+            void startFrame();
+            void endFrame();
+            
+            //Statistics for the last finished frame
+            //  (GPU times are filled in two frames later)
+            const renderStats_t& getFrameStats() const;
+            
+            //Number of frames of statistics to keep (default 600)
+            void setStatsHistory(size_t frames);
+            
+            //Write kept frame statistics to file
+            bool saveStatsCSV(const std::string& filename) const;
+            bool saveStatsJSON(const std::string& filename) const;
 
 
             //
@@ -129,6 +216,24 @@ namespace mc__ {
             void viewport( GLint x, GLint y, GLsizei width, GLsizei height);
             void setDrawDistance( GLdouble d);
             
+            //Distance in map chunks to start drawing 2x2x2 and 4x4x4 cells
+            //  (0 = never use that level of detail)
+            void setLODDistance( uint16_t lod2, uint16_t lod4);
+            
+            //Camera distance in blocks before translucent blocks are resorted
+            void setResortDistance( GLfloat blocks);
+            
+            //Only draw items within distance (blocks), nearest limit items
+            //  (0 = no limit)
+            void setItemLimits( GLfloat distance, size_t limit);
+            
+            //Keep at most count item models compiled (0 = no limit)
+            void setItemModelLimit( size_t count);
+            
+            //Compile models for item IDs before they are first drawn, a few
+            // at the start of each frame
+            void prewarmItemModels( const std::vector<uint16_t>& IDs);
+            
             //Export functions
             bool writeChunkBin(mc__::Chunk *chunk,
                 const std::string& filename) const;
@@ -143,6 +248,10 @@ namespace mc__ {
             //Relate world mapchunks to GL lists
             mapChunkUintMap_t glListMap;
             mapChunkUintMap_t glListMapOccluded;
+            mapChunkLODMap_t glListMapLOD;
+
+            //Delete all GL lists of map chunk (world is evicting it)
+            void freeMapChunk(mc__::MapChunk* mapchunk);
             
         protected:
             
@@ -151,6 +260,9 @@ namespace mc__ {
             unsigned short view_width, view_height;
             GLfloat aspectRatio, fieldOfViewY;
             
+            //Map chunk distance to switch to 2x2x2 and 4x4x4 cells
+            uint16_t lodDistance[2];
+            
             //Current camera angle
             GLfloat cam_yaw, cam_pitch, cam_vecX, cam_vecY, cam_vecZ;
             
@@ -167,9 +279,62 @@ namespace mc__ {
 
             //GL display list of terrain display lists that player cannot see
             GLuint glListCamera;
-
-            //Map ID to GL display list
+            
+            //Map chunks nearest first
+            mapChunkList_t drawOrder;
+            
+            //Full detail map chunks drawn this frame
+            mapChunkList_t drawnChunks;
+            
+            //Translucent blocks of full detail map chunks, and hash of the
+            // drawn map chunks that had them when last sorted
+            mapChunkTranslucentMap_t translucentBlocks;
+            bool translucentChanged;
+            uint64_t translucentChunks;
+            
+            //Back to front translucent list, camera position it was sorted
+            // for, and sort running on a worker thread
+            GLuint translucentList;
+            GLfloat sortCam[3];
+            GLfloat resortDistance;
+            std::future<translucentList_t> translucentSort;
+
+            //Statistics for this frame, and previous frames
+            renderStats_t frameStats;
+            std::deque<renderStats_t> statsHistory;
+            size_t statsHistoryMax;
+            listQuadMap_t listQuads;
+            
+            //GL timer queries for map chunks and mobiles, two frames worth
+            //  (0 if timer queries are not available)
+            GLuint timerQueries[2][2];
+            bool timerStarted[2][2];
+            void startTimer(uint8_t section);
+            void stopTimer(uint8_t section);
+            
+            //Count a compiled or called display list in frameStats
+            void countCompiled(GLuint gl_list, uint32_t quads,
+                std::chrono::steady_clock::time_point started);
+            void countCalled(GLuint gl_list);
+
+            //Item draw distance (blocks) and count, items to draw this frame
+            GLfloat itemDistance;
+            size_t itemLimit;
+            std::vector<uint32_t> nearSlots;
+            itemInstanceList_t itemInstances;
+
+            //Map ID to GL display list (0 until the item is first drawn)
             GLuint itemModels[item_id_MAX];
+            
+            //Frame each item model was last drawn, IDs with a compiled
+            // model, and how many to keep
+            uint32_t itemModelUsed[item_id_MAX];
+            std::vector<uint16_t> itemModelIDs;
+            size_t itemModelLimit;
+            
+            //Item IDs waiting to be prewarmed
+            std::deque<uint16_t> itemPrewarm;
+            static const size_t item_PREWARM_PER_FRAME = 4;
             GLuint entityModels[entity_type_MAX];
 
             //Init functions
@@ -178,8 +343,35 @@ namespace mc__ {
                 uint8_t properties, uint16_t offset=0);
             bool loadItemInfo();
 
+            //Compile display lists for a map chunk
+            void compileMapChunk(mc__::MapChunk& mapchunk, GLuint gl_list);
+            void compileMapChunkLOD(mc__::MapChunk& mapchunk, GLuint gl_list,
+                uint8_t step);
+            
+            //Cell size to draw map chunk with (1 = every block)
+            uint8_t getLODStep(const mc__::MapChunk& mapchunk) const;
+            
+            //Face directions of map chunk that camera could see (visflags)
+            uint8_t getFacingFlags(const mc__::MapChunk& mapchunk) const;
+            
+            //Which render layer a block is drawn in
+            static layer_t getLayer(uint8_t blockID);
+            
+            //Delete full detail lists of map chunk, and its translucent blocks
+            void freeMapChunkLists(mc__::MapChunk* mapchunk);
+            
+            //Sort translucent blocks on worker thread, compile when done
+            void updateTranslucent();
+            void compileTranslucent(const translucentList_t& sorted);
+
             //Create display list for ID after loadItemInfo has been called
             bool createItemModel( uint16_t ID);
+            
+            //Display list for item ID, compiled on first use
+            GLuint getItemModel( uint16_t ID);
+            
+            //Delete least recently drawn item model not drawn this frame
+            bool evictItemModel();
 
             //Create display lists for all IDs
             //bool createItemModels();
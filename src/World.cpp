@@ -19,23 +19,39 @@
     <http://www.gnu.org/licenses/>.
 */
 
+//C
+#include <cstdio>   //rename, remove
+#include <cmath>    //floor
+#include <cstring>  //memcpy
+
 //STL
 #include <iostream>
+#include <sstream>
+#include <algorithm>    //sort
+#include <utility>      //move
 using std::cerr;
 using std::cout;
 using std::endl;
 using std::hex;
 using std::dec;
+using std::string;
+using std::stringstream;
 
 //mc--
 #include "World.hpp"
 using mc__::World;
 using mc__::Chunk;
 using mc__::Block;
+using mc__::MapChunk;
+using mc__::Region;
+using mc__::Snapshot;
+using mc__::ThreadPool;
 
 //Create empty world
 World::World(): spawn_X(0), spawn_Y(0), spawn_Z(0),
-    name("My World"), debugging(false)
+    name("My World"), regionPath("."), debugging(false), memoryBudget(0),
+    snapshotGeneration(0), chunkMap(epoch), pendingSequence(0),
+    pendingSorted(false), pendingFocus_X(0), pendingFocus_Z(0)
 {
 }
 
@@ -44,7 +60,10 @@ World::World( const World& w):
     /* coordMapChunks( w.coordMapChunks), mapChunks( w.mapChunks),
     chunkUpdates( w.chunkUpdates),*/
     spawn_X( w.spawn_X), spawn_Y( w.spawn_Y), spawn_Z( w.spawn_Z),
-    name( w.name), debugging(w.debugging)
+    name( w.name), regionPath( w.regionPath), debugging(w.debugging),
+    memoryBudget( w.memoryBudget), snapshotGeneration(0), chunkMap(epoch),
+    pendingSequence(0), pendingSorted(false), pendingFocus_X(0),
+    pendingFocus_Z(0)
     
 {
 
@@ -64,6 +83,7 @@ World::World( const World& w):
             
             //Add to our coordMapChunks
             coordMapChunks.insert(XZMapChunk_t::value_type(iter_xz->first, mc));
+            chunkMap.insert(iter_xz->first, mc);
         }
     }
 
@@ -75,7 +95,7 @@ World::World( const World& w):
         Chunk* chunk = *iter_chunk;
         if ( chunk != NULL) {
             chunk = new Chunk(*chunk);
-            chunkUpdates.insert( chunk );
+            addChunkUpdate( chunk );
         }
     }
 }
@@ -105,6 +125,15 @@ World::~World()
             cerr << "delete Null Chunk" << endl;}
     }
     chunkUpdates.clear();
+
+    //Unmap region files
+    XZRegion_t::iterator iter_region;
+    for (iter_region = regions.begin(); iter_region != regions.end();
+        iter_region++)
+    {
+        delete iter_region->second;
+    }
+    regions.clear();
 }
 
 //Add compressed chunk to list/map
@@ -112,22 +141,34 @@ World::~World()
 bool World::addChunkZip(int32_t X, int8_t Y, int32_t Z,
     uint8_t size_X, uint8_t size_Y, uint8_t size_Z,
     uint32_t ziplength, uint8_t *zipped, bool unzip)
+{
+    //Caller keeps zipped, chunk gets a copy
+    std::unique_ptr<uint8_t[]> copy(new uint8_t[ziplength]);
+    memcpy(copy.get(), zipped, ziplength);
+    return addChunkZip(X, Y, Z, size_X, size_Y, size_Z, ziplength,
+        std::move(copy), unzip);
+}
+
+//Add compressed chunk to list/map, chunk owns zipped
+bool World::addChunkZip(int32_t X, int8_t Y, int32_t Z,
+    uint8_t size_X, uint8_t size_Y, uint8_t size_Z,
+    uint32_t ziplength, std::unique_ptr<uint8_t[]> zipped, bool unzip)
 {
     bool result=false;
-    
-    Chunk* chunk = new Chunk(size_X, size_Y, size_Z, X, Y, Z);
+
+    //No block_array or byte_array until unzipped
+    Chunk* chunk = new Chunk(size_X, size_Y, size_Z, X, Y, Z, false);
     if (chunk) {
-        chunk->copyZip(ziplength, zipped);
+        chunk->adoptZip(ziplength, zipped.release());
         addChunkUpdate(chunk);
-        
-        //byte_array and block_array are still NULL!
+
+        //Unzip to block_array, compressed and packed data are not needed
         if (unzip) {
-            result = chunk->unzip(false);
-            chunk->unpackBlocks(false);
+            result = chunk->unzip(true);
         } else {
             result=true;
         }
-        
+
     }
     return result;
 }
@@ -163,7 +204,12 @@ bool World::addChunkUpdate( Chunk *chunk)
     if (chunk == NULL) { return false; }
     
     //Add chunk to set.  Ignores duplicate pointer adds ;p
-    chunkUpdates.insert(chunk);
+    if (chunkUpdates.insert(chunk).second) {
+        pendingChunk_t pending = { chunk, pendingSequence++, MapChunk::now(),
+            0 };
+        pendingChunks.push_back(pending);
+        pendingSorted = false;
+    }
     
     return true;
 
@@ -183,6 +229,12 @@ mc__::MapChunk* World::getChunk(int32_t X, int32_t Z)
     return result;
 }
 
+//Map chunk containing block X,Z, from any thread
+mc__::MapChunk* World::findChunk(int32_t X, int32_t Z) const
+{
+    return chunkMap.find(getKey(X&0xFFFFFFF0, Z&0xFFFFFFF0));
+}
+
 //Constant pointer getChunk
 const mc__::MapChunk* World::getChunk(int32_t X, int32_t Z) const
 {    
@@ -203,8 +255,7 @@ mc__::MapChunk World::copyChunk(int32_t X, int32_t Z) const
     uint64_t key = getKey(X, Z);
     XZMapChunk_t::const_iterator iter_xz = coordMapChunks.find(key);
     if (iter_xz != coordMapChunks.end()) {
-        //TODO: Chunk and MapChunk copy constructor
-        const mc__::MapChunk *result = iter_xz->second; 
+        const mc__::MapChunk *result = iter_xz->second;
         return *result;
     } else {
         cerr << "copyChunk: not found @ " << X << "," << Z << endl;
@@ -235,8 +286,10 @@ mc__::Block World::getBlock(int32_t X, int8_t Y, int32_t Z) const {
     //Return "air" if not found.
     mc__::Block result = {0, 0, 0, 0};
     
-    const Chunk *chunk = getChunk( X&0xFFFFFFF0, Z&0xFFFFFFF0);
-    if (chunk != NULL && Y >= 0)
+    //Uncompressing a cold chunk does not change its blocks
+    MapChunk *chunk = const_cast<MapChunk*>(
+        getChunk( X&0xFFFFFFF0, Z&0xFFFFFFF0));
+    if (chunk != NULL && Y >= 0 && (!chunk->isCold() || chunk->thaw()))
     {
         //Get block @ X,Y,Z
         uint16_t index = ((X&0xF)<<11)|((Z&0xF)<<7)|(Y&0x7F);
@@ -269,6 +322,7 @@ bool World::addMapChunk( const Chunk* chunk)
         //Create a new MapChunk in coordMapChunks if needed
         mapchunk = new MapChunk(X, Z);
         coordMapChunks.insert( XZMapChunk_t::value_type(key, mapchunk));
+        chunkMap.insert(key, mapchunk);
         mapChunks.push_back( mapchunk );
         
         MapChunk* neighbor;
@@ -315,10 +369,200 @@ bool World::addMapChunk( const Chunk* chunk)
     
     //Finally, add the mini-chunk to the MapChunk
     result = mapchunk->addChunk(chunk);
+
+    //Complete map chunk may be the same as another one
+    if (result && chunk->size_X == 15 && chunk->size_Y == 127 &&
+        chunk->size_Z == 15)
+    {
+        mapchunk->shareBlocks();
+    }
     
     return result;
 }
 
+//Apply block changes to one map chunk
+size_t World::setBlocks(int32_t X, int32_t Z,
+    const MapChunk::blockChange_t* changes, size_t count)
+{
+    MapChunk *mapchunk = getChunk(X&0xFFFFFFF0, Z&0xFFFFFFF0);
+    if (mapchunk == NULL) {
+        return 0;
+    }
+    return mapchunk->setBlocks(changes, count);
+}
+
+//Apply one block change
+bool World::setBlock(int32_t X, int8_t Y, int32_t Z,
+    uint8_t blockID, uint8_t metadata)
+{
+    if (Y < 0) {
+        return false;
+    }
+    MapChunk::blockChange_t change;
+    change.coord = ((X&0xF)<<12)|((Z&0xF)<<8)|(Y&0x7F);
+    change.blockID = blockID;
+    change.metadata = metadata;
+
+    MapChunk *mapchunk = getChunk(X&0xFFFFFFF0, Z&0xFFFFFFF0);
+    if (mapchunk == NULL) {
+        return false;
+    }
+    mapchunk->setBlocks(&change, 1);
+    return true;
+}
+
+//Remove map chunk at X,Z from world
+bool World::removeMapChunk(int32_t X, int32_t Z)
+{
+    uint64_t key = getKey(X & 0xFFFFFFF0, Z & 0xFFFFFFF0);
+    XZMapChunk_t::iterator iter = coordMapChunks.find(key);
+    if (iter == coordMapChunks.end()) {
+        return false;
+    }
+    MapChunk *mapchunk = iter->second;
+    coordMapChunks.erase(iter);
+    mapChunks.erase(std::find(mapChunks.begin(), mapChunks.end(), mapchunk));
+    deleteMapChunk(mapchunk);
+    epoch.reclaim();
+
+    return true;
+}
+
+//Remove map chunks farthest from X,Z until memory fits budget
+size_t World::evictChunks(double X, double Z)
+{
+    if (memoryBudget == 0) {
+        return 0;
+    }
+    size_t total = getMemory().total;
+    if (total <= memoryBudget) {
+        return 0;
+    }
+
+    //Sort map chunks nearest first, by distance from their center
+    std::vector< std::pair<double, MapChunk*> > order;
+    order.reserve(mapChunks.size());
+    mapChunkList_t::const_iterator iter;
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        double dx = (*iter)->X + 8 - X;
+        double dz = (*iter)->Z + 8 - Z;
+        order.push_back(std::make_pair(dx*dx + dz*dz, *iter));
+    }
+    std::sort(order.begin(), order.end());
+
+    //Remove from the far end, always keep the nearest
+    size_t count = order.size();
+    while (total > memoryBudget && count > 1) {
+        MapChunk *mapchunk = order[--count].second;
+        total -= mapchunk->getMemory().total;
+        coordMapChunks.erase(getKey(mapchunk->X, mapchunk->Z));
+        deleteMapChunk(mapchunk);
+    }
+
+    epoch.reclaim();
+
+    //Keep the remaining map chunks (nearest first)
+    size_t result = order.size() - count;
+    mapChunks.clear();
+    for (size_t i = 0; i < count; i++) {
+        mapChunks.push_back(order[i].second);
+    }
+
+    return result;
+}
+
+//Compress map chunks far from X,Z that were not used recently
+size_t World::freezeIdle(double X, double Z, double distance, double seconds)
+{
+    double idle = MapChunk::now() - seconds;
+    size_t result=0;
+
+    mapChunkList_t::const_iterator iter;
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        MapChunk *mapchunk = *iter;
+        if (mapchunk->isCold() || mapchunk->lastUsed > idle) {
+            continue;
+        }
+        double dx = mapchunk->X + 8 - X;
+        double dz = mapchunk->Z + 8 - Z;
+        if (dx*dx + dz*dz > distance*distance && mapchunk->freeze()) {
+            result++;
+        }
+    }
+
+    return result;
+}
+
+//Read-only view of all map chunks
+std::shared_ptr<const Snapshot> World::takeSnapshot()
+{
+    std::shared_ptr<Snapshot> result(new Snapshot());
+    result->generation = ++snapshotGeneration;
+    result->chunks.reserve(mapChunks.size());
+
+    mapChunkList_t::const_iterator iter;
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        MapChunk *mapchunk = *iter;
+        Snapshot::chunk_t& chunk =
+            result->chunks[Snapshot::getKey(mapchunk->X, mapchunk->Z)];
+        chunk.X = mapchunk->X;
+        chunk.Z = mapchunk->Z;
+        chunk.generation = mapchunk->generation;
+
+        //Cold map chunk has no blocks to share, copy its compressed data
+        if (mapchunk->isCold()) {
+            chunk.zipped.assign(mapchunk->zipped,
+                mapchunk->zipped + mapchunk->zipped_length);
+        } else {
+            chunk.blocks = mapchunk->getSharedBlocks();
+        }
+    }
+
+    return result;
+}
+
+//Bytes used by all map chunks, by component
+MapChunk::memory_t World::getMemory() const
+{
+    MapChunk::memory_t result = { 0, 0, 0, 0, 0, 0, 0 };
+
+    mapChunkList_t::const_iterator iter;
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        MapChunk::memory_t memory = (*iter)->getMemory();
+        result.object += memory.object;
+        result.visflags += memory.visflags;
+        result.blocks += memory.blocks;
+        result.packed += memory.packed;
+        result.zipped += memory.zipped;
+        result.visible += memory.visible;
+        result.total += memory.total;
+    }
+
+    return result;
+}
+
+//Unlink neighbors, call evict handler, retire map chunk to epoch
+void World::deleteMapChunk(MapChunk* mapchunk)
+{
+    //No new reader can find it
+    chunkMap.erase(getKey(mapchunk->X, mapchunk->Z));
+
+    //Neighbor on face i links back on the opposite face (i^1)
+    for (uint8_t i = 0; i < 6; i++) {
+        MapChunk *neighbor = mapchunk->neighbors[i].exchange(NULL);
+        if (neighbor != NULL) {
+            neighbor->neighbors[i^1] = NULL;
+        }
+    }
+
+    if (evictHandler) {
+        evictHandler(mapchunk);
+    }
+
+    //Readers that found it may still be using it
+    epoch.retire([mapchunk]() { delete mapchunk; });
+}
+
 //Set map chunk flags at X/Z (create one if needed)
 void World::setChunkFlags( int32_t X, int32_t Z, uint32_t setflags)
 {
@@ -369,64 +613,291 @@ uint32_t World::getChunkFlags( int32_t X, int32_t Z)
     return result;
 }
 
-//Mark all mapchunks as needing redrawing
-void World::redraw()
+//Recalculate visibility of all map chunks on threads
+void World::redraw(size_t threads)
+{
+    //Uncompress cold map chunks first, thaw changes shared counters
+    mapChunkList_t::const_iterator iter;
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        (*iter)->thaw();
+    }
+
+    if (!redrawPool || (threads != 0 && redrawPool->size() != threads)) {
+        redrawPool.reset(new ThreadPool(threads));
+    }
+    if (redrawPool->size() == 1) {
+        for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+            (*iter)->recalcVis();
+        }
+        return;
+    }
+
+    //recalcVis changes visflags, visibleIndices, and flags of the four
+    // neighbors.  Map chunks in the same phase are 3 apart on X or Z, so
+    // they have no neighbors in common.
+    std::vector<MapChunk*> phases[9];
+    for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++) {
+        int32_t x = (((*iter)->X >> 4) % 3 + 3) % 3;
+        int32_t z = (((*iter)->Z >> 4) % 3 + 3) % 3;
+        phases[x*3 + z].push_back(*iter);
+    }
+    for (uint8_t phase = 0; phase < 9; phase++) {
+        const std::vector<MapChunk*>& chunks = phases[phase];
+        redrawPool->run(chunks.size(),
+            [&chunks](size_t i) { chunks[i]->recalcVis(); });
+    }
+}
+
+//Save loaded map chunks in region containing block X,Z
+bool World::saveRegion(int32_t X, int32_t Z)
+{
+    //Corner of region
+    int32_t region_X = (X >> Region::region_SHIFT) << Region::region_SHIFT;
+    int32_t region_Z = (Z >> Region::region_SHIFT) << Region::region_SHIFT;
+
+    //Compressed data for each slot, from map or from old region file
+    const uint8_t* data[Region::region_CHUNKS];
+    uint32_t length[Region::region_CHUNKS];
+    MapChunk* zipped[Region::region_CHUNKS];
+    const Region* oldRegion = getRegion(X, Z);
+
+    for (uint16_t slot = 0; slot < Region::region_CHUNKS; slot++) {
+        int32_t chunk_X = region_X + ((slot & 0x1F) << 4);
+        int32_t chunk_Z = region_Z + ((slot >> 5) << 4);
+        data[slot] = NULL;
+        length[slot] = 0;
+        zipped[slot] = NULL;
+
+        MapChunk* mapchunk = getChunk(chunk_X, chunk_Z);
+        if (mapchunk != NULL && (mapchunk->flags & MapChunk::LOADED) &&
+            mapchunk->thaw())
+        {
+            //Compress the map chunk
+            mapchunk->packBlocks();
+            if (mapchunk->zip()) {
+                data[slot] = mapchunk->zipped;
+                length[slot] = mapchunk->zipped_length;
+                zipped[slot] = mapchunk;
+            }
+        } else if (oldRegion != NULL) {
+            //Keep chunk saved earlier
+            if (!oldRegion->getChunk(chunk_X, chunk_Z,
+                data[slot], length[slot]))
+            {
+                data[slot] = NULL;
+            }
+        }
+    }
+
+    //Write new file, then replace the old one
+    string filename = getRegionFile(X, Z);
+    string tempname = filename + ".tmp";
+    bool result = Region::write(tempname, data, length);
+
+    //Free compressed copies
+    for (uint16_t slot = 0; slot < Region::region_CHUNKS; slot++) {
+        if (zipped[slot] != NULL) {
+            zipped[slot]->deleteZipArray();
+            zipped[slot]->zipped_length = 0;
+        }
+    }
+
+    //Nothing may have the old file mapped while it is replaced (_WIN32
+    // can't remove or rename a mapped file); the loader maps the new one
+    // when it resumes
+    loader.pauseRegions();
+    closeRegion(X, Z);
+    if (result) {
+        remove(filename.c_str());
+        if (rename(tempname.c_str(), filename.c_str()) != 0) {
+            cerr << "Unable to replace region file " << filename << endl;
+            result = false;
+        }
+    }
+    loader.resumeRegions();
+
+    return result;
+}
+
+//Save every region with loaded map chunks
+size_t World::saveRegions()
 {
-    //Use the mapChunkList of all map chunks to draw them
+    //Find regions of loaded map chunks
+    std::unordered_set<uint64_t> saved;
+    size_t result=0;
+
     mapChunkList_t::const_iterator iter;
     for (iter = mapChunks.begin(); iter != mapChunks.end(); iter++)
     {
-        (*iter)->recalcVis();
+        const MapChunk *mapchunk = *iter;
+        if ((mapchunk->flags & MapChunk::LOADED) == 0) {
+            continue;
+        }
+        int32_t region_X = mapchunk->X >> Region::region_SHIFT;
+        int32_t region_Z = mapchunk->Z >> Region::region_SHIFT;
+        if (saved.insert(getKey(region_X, region_Z)).second &&
+            saveRegion(mapchunk->X, mapchunk->Z))
+        {
+            result++;
+        }
     }
 
+    return result;
 }
 
-//Unzip all mini-chunks into MapChunks
-bool World::updateMapChunks(bool cleanup)
+//Load map chunks from region file containing block X,Z
+size_t World::loadRegion(int32_t X, int32_t Z)
+{
+    const Region* region = getRegion(X, Z);
+    if (region == NULL) {
+        return 0;
+    }
+    int32_t region_X = (X >> Region::region_SHIFT) << Region::region_SHIFT;
+    int32_t region_Z = (Z >> Region::region_SHIFT) << Region::region_SHIFT;
+    size_t result=0;
+
+    for (uint16_t slot = 0; slot < Region::region_CHUNKS; slot++) {
+        int32_t chunk_X = region_X + ((slot & 0x1F) << 4);
+        int32_t chunk_Z = region_Z + ((slot >> 5) << 4);
+        const uint8_t* data;
+        uint32_t length;
+
+        //Skip chunks already loaded, and chunks not in file
+        if ((getChunkFlags(chunk_X, chunk_Z) & MapChunk::LOADED) == 0 &&
+            region->getChunk(chunk_X, chunk_Z, data, length) &&
+            addMapChunkZip(chunk_X, chunk_Z, data, length))
+        {
+            result++;
+        }
+    }
+
+    return result;
+}
+
+//Load map chunk at X,Z from its region file
+bool World::loadChunk(int32_t X, int32_t Z)
 {
+    const Region* region = getRegion(X, Z);
+    const uint8_t* data;
+    uint32_t length;
 
-    //Apply all unused mini-chunks to map then delete them
-    chunkSet_t::const_iterator iter_chunk;
-    for (iter_chunk = chunkUpdates.begin(); iter_chunk != chunkUpdates.end();
-        iter_chunk++)
+    if (region == NULL || !region->getChunk(X, Z, data, length)) {
+        return false;
+    }
+    return addMapChunkZip(X & 0xFFFFFFF0, Z & 0xFFFFFFF0, data, length);
+}
+
+//Load map chunk at X,Z on the loader thread
+bool World::requestChunk(int32_t X, int32_t Z)
+{
+    if ((getChunkFlags(X & 0xFFFFFFF0, Z & 0xFFFFFFF0) & MapChunk::LOADED)
+        != 0)
     {
-        Chunk* chunk=*iter_chunk;
-        if ( chunk != NULL)
+        return false;
+    }
+    if (!loader.isRunning()) {
+        loader.start(regionPath);
+    }
+    loader.request(X, Z);
+    return true;
+}
+
+//Add chunks finished by the loader to the map
+size_t World::applyLoads(size_t max)
+{
+    std::vector<Chunk*> chunks;
+    loader.collect(chunks, max);
+    size_t result=0;
+
+    std::vector<Chunk*>::const_iterator iter;
+    for (iter = chunks.begin(); iter != chunks.end(); iter++) {
+        Chunk* chunk = *iter;
+
+        //Chunk from server may have arrived first
+        if ((getChunkFlags(chunk->X, chunk->Z) & MapChunk::LOADED) == 0 &&
+            addMapChunk(chunk))
         {
-            //Get the next chunk pointer
-            Chunk* chunk = *iter_chunk;
-            
-            //Unzip chunk if needed
-            if (! chunk->isUnzipped ) {
-                chunk->unzip(true);
-            }
-            
-            //Add chunk to map (uncompresses if needed)
-            if (addMapChunk(chunk)) {
-              
-                //Mark "LOADED" if this was a full size map chunk
-                if (chunk->size_Y > 126) {
-                    setChunkFlags(chunk->X, chunk->Z, MapChunk::LOADED);
-                }
-                
-                //DEBUG
-                if (debugging) {
-                  cout << "Updated chunk to map @ " << chunk->X
-                      << "," << (int)chunk->Y << "," << chunk->Z << endl;
-                }
-            } else {
-                cerr << "Error updating chunk to map @ X=" << chunk->X
-                << " Y=" << (int)chunk->Y << " Z=" << chunk->Z << endl;
-            }
-            
-            //Delete the mini-chunk
-            if (cleanup) { delete chunk; chunk = NULL;}
-        } else {
-            cerr << "update Null Chunk" << endl;
+            setChunkFlags(chunk->X, chunk->Z, MapChunk::DRAWABLE);
+            result++;
         }
-        
+        delete chunk;
+    }
+
+    return result;
+}
+
+//Mapped region file containing block X,Z
+Region* World::getRegion(int32_t X, int32_t Z)
+{
+    uint64_t key = getKey(X >> Region::region_SHIFT, Z >> Region::region_SHIFT);
+    XZRegion_t::const_iterator iter = regions.find(key);
+    if (iter != regions.end()) {
+        return iter->second;
     }
 
+    //Open the file once, remember if it is missing
+    Region* region = new Region();
+    if (!region->open(getRegionFile(X, Z))) {
+        delete region;
+        region = NULL;
+    }
+    regions.insert(XZRegion_t::value_type(key, region));
+
+    return region;
+}
+
+//Unmap region file containing block X,Z
+void World::closeRegion(int32_t X, int32_t Z)
+{
+    uint64_t key = getKey(X >> Region::region_SHIFT, Z >> Region::region_SHIFT);
+    XZRegion_t::iterator iter = regions.find(key);
+    if (iter != regions.end()) {
+        delete iter->second;
+        regions.erase(iter);
+    }
+}
+
+//Region file name for block X,Z
+string World::getRegionFile(int32_t X, int32_t Z) const
+{
+    stringstream filename;
+    filename << regionPath << "/region_" << (X >> Region::region_SHIFT)
+        << "_" << (Z >> Region::region_SHIFT) << ".mcr";
+    return filename.str();
+}
+
+//Add compressed map chunk at X,Z to map
+bool World::addMapChunkZip(int32_t X, int32_t Z,
+    const uint8_t* data, uint32_t length)
+{
+    Chunk chunk(15, 127, 15, X, 0, Z, false);
+    chunk.copyZip(length, data);
+    if (!chunk.unzip(true) || !addMapChunk(&chunk)) {
+        cerr << "Error loading chunk from region @ X=" << X
+            << " Z=" << Z << endl;
+        return false;
+    }
+
+    //Mark loaded, draw it
+    setChunkFlags(X, Z, MapChunk::DRAWABLE);
+    return true;
+}
+
+//Unzip all mini-chunks into MapChunks, in arrival order
+bool World::updateMapChunks(bool cleanup)
+{
+    std::sort(pendingChunks.begin(), pendingChunks.end(),
+        [](const pendingChunk_t& a, const pendingChunk_t& b) {
+            return a.sequence < b.sequence;
+        });
+
+    //Apply all unused mini-chunks to map then delete them
+    std::vector<pendingChunk_t>::const_iterator iter;
+    for (iter = pendingChunks.begin(); iter != pendingChunks.end(); iter++) {
+        applyChunkUpdate(iter->chunk, cleanup);
+    }
+    pendingChunks.clear();
+
     //Clear the mini-chunk list
     if (cleanup) { chunkUpdates.clear(); }
 
@@ -434,6 +905,112 @@ bool World::updateMapChunks(bool cleanup)
 
 }
 
+//Unzip mini-chunks nearest to X,Z into MapChunks until budget is used
+size_t World::updateMapChunks(double X, double Z, double budget,
+    size_t maxChunks, bool cleanup)
+{
+    double start = MapChunk::now();
+
+    //Sort again when chunks arrive or focus moves to another map chunk
+    int32_t focus_X = (int32_t)floor(X) & 0xFFFFFFF0;
+    int32_t focus_Z = (int32_t)floor(Z) & 0xFFFFFFF0;
+    if (!pendingSorted || focus_X != pendingFocus_X ||
+        focus_Z != pendingFocus_Z)
+    {
+        std::vector<pendingChunk_t>::iterator iter;
+        for (iter = pendingChunks.begin(); iter != pendingChunks.end();
+            iter++)
+        {
+            double dx = (int32_t)(iter->chunk->X & 0xFFFFFFF0) + 8 - X;
+            double dz = (int32_t)(iter->chunk->Z & 0xFFFFFFF0) + 8 - Z;
+            iter->distance = dx*dx + dz*dz;
+        }
+
+        //Farthest first; chunks of one map chunk in reverse arrival order,
+        // so they are applied in arrival order
+        std::sort(pendingChunks.begin(), pendingChunks.end(),
+            [](const pendingChunk_t& a, const pendingChunk_t& b) {
+                if (a.distance != b.distance) {
+                    return a.distance > b.distance;
+                }
+                return a.sequence > b.sequence;
+            });
+        pendingSorted = true;
+        pendingFocus_X = focus_X;
+        pendingFocus_Z = focus_Z;
+    }
+
+    //Nearest is at the back
+    size_t result=0;
+    while (!pendingChunks.empty()) {
+        if (result > 0 && ((maxChunks > 0 && result >= maxChunks) ||
+            (budget > 0 && (MapChunk::now() - start)*1000 >= budget)))
+        {
+            break;
+        }
+        Chunk *chunk = pendingChunks.back().chunk;
+        pendingChunks.pop_back();
+        if (cleanup) {
+            chunkUpdates.erase(chunk);
+        }
+        applyChunkUpdate(chunk, cleanup);
+        result++;
+    }
+
+    return result;
+}
+
+//Seconds the oldest pending mini-chunk has waited
+double World::pendingAge() const
+{
+    if (pendingChunks.empty()) {
+        return 0;
+    }
+    double oldest = pendingChunks[0].arrived;
+    std::vector<pendingChunk_t>::const_iterator iter;
+    for (iter = pendingChunks.begin(); iter != pendingChunks.end(); iter++) {
+        if (iter->arrived < oldest) {
+            oldest = iter->arrived;
+        }
+    }
+    return MapChunk::now() - oldest;
+}
+
+//Add one mini-chunk to the map, delete it if cleanup
+void World::applyChunkUpdate(Chunk *chunk, bool cleanup)
+{
+    if (chunk == NULL) {
+        cerr << "update Null Chunk" << endl;
+        return;
+    }
+
+    //Unzip chunk if needed
+    if (! chunk->isUnzipped ) {
+        chunk->unzip(true);
+    }
+
+    //Add chunk to map (uncompresses if needed)
+    if (addMapChunk(chunk)) {
+
+        //Mark "LOADED" if this was a full size map chunk
+        if (chunk->size_Y > 126) {
+            setChunkFlags(chunk->X, chunk->Z, MapChunk::LOADED);
+        }
+
+        //DEBUG
+        if (debugging) {
+          cout << "Updated chunk to map @ " << chunk->X
+              << "," << (int)chunk->Y << "," << chunk->Z << endl;
+        }
+    } else {
+        cerr << "Error updating chunk to map @ X=" << chunk->X
+        << " Y=" << (int)chunk->Y << " Z=" << chunk->Z << endl;
+    }
+
+    //Delete the mini-chunk
+    if (cleanup) { delete chunk; }
+}
+
 //Generate chunk representing block ID 0 - 95
 bool World::genChunkTest(int32_t X, int8_t Y, int32_t Z) {
     
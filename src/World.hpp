@@ -25,9 +25,17 @@
 
 //mc__ classes
 #include "MapChunk.hpp" //includes "Chunk.hpp"
+#include "Region.hpp"
+#include "ChunkLoader.hpp"
+#include "Snapshot.hpp"
+#include "Epoch.hpp"
+#include "ChunkMap.hpp"
+#include "ThreadPool.hpp"
 
 //STL
 #include <unordered_map>      //map / unordered_map / hash_map
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -43,6 +51,12 @@ namespace mc__ {
     //Straight list of map-chunks loaded in world
     typedef std::vector< MapChunk* > mapChunkList_t;
 
+    //Called with map chunk before it is deleted
+    typedef std::function<void(mc__::MapChunk*)> evictHandler_t;
+
+    //Map region coordinates to mapped region file (NULL if no file)
+    typedef std::unordered_map< uint64_t, Region* > XZRegion_t;
+
     //World class ;)
     class World {
         
@@ -60,10 +74,22 @@ namespace mc__ {
             bool addChunkZip(int32_t X, int8_t Y, int32_t Z,
                 uint8_t size_X, uint8_t size_Y, uint8_t size_Z,
                 uint32_t ziplength, uint8_t *zipped, bool unzip=true);
+
+            //Add compressed chunk to list/map, taking the buffer instead of
+            // copying it
+            bool addChunkZip(int32_t X, int8_t Y, int32_t Z,
+                uint8_t size_X, uint8_t size_Y, uint8_t size_Z,
+                uint32_t ziplength, std::unique_ptr<uint8_t[]> zipped,
+                bool unzip=true);
             
             //Return chunk at X,Z
             mc__::MapChunk* getChunk(int32_t X, int32_t Z);
             const mc__::MapChunk* getChunk(int32_t X, int32_t Z) const;
+
+            //Map chunk containing block X,Z, from any thread (NULL if none)
+            //  Hold an Epoch::Guard on epoch while using the result; removed
+            //  map chunks are deleted only after the guard is gone.
+            mc__::MapChunk* findChunk(int32_t X, int32_t Z) const;
             mc__::MapChunk copyChunk(int32_t X, int32_t Z) const;
             
             //Return copy of block at X,Y,Z (0xFF if failed)
@@ -74,14 +100,37 @@ namespace mc__ {
                 uint8_t size_X, uint8_t size_Y, uint8_t size_Z,
                 bool unzipped=true);
             
-            //Unzip all new chunks into MapChunks
+            //Unzip all new chunks into MapChunks, in the order they arrived
             bool updateMapChunks(bool cleanup=true);
+
+            //Unzip new chunks into MapChunks, nearest to block X,Z first,
+            // until budget milliseconds (0 = no limit) or maxChunks (0 = no
+            // limit) is used.  At least one chunk is applied, the rest wait
+            // for the next call.  Returns number of chunks applied.
+            size_t updateMapChunks(double X, double Z, double budget,
+                size_t maxChunks=0, bool cleanup=true);
+
+            //New chunks waiting for updateMapChunks, and seconds the oldest
+            // one has waited (0 if none)
+            size_t pendingCount() const { return pendingChunks.size(); };
+            double pendingAge() const;
             
-            //Mark all mapchunks as "updated", will be redrawn
-            void redraw();
+            //Recalculate visibility of all map chunks on threads (0 = one
+            // per core), they will be redrawn
+            void redraw(size_t threads=0);
 
             //Add one mini-chunk to the map
             bool addMapChunk( const mc__::Chunk *chunk);
+
+            //Apply block changes to the map chunk at X/Z in one pass
+            //  (GAME_MULTI_BLOCK_CHANGE).  Returns number of blocks changed,
+            //  0 if the map chunk is not loaded.
+            size_t setBlocks(int32_t X, int32_t Z,
+                const mc__::MapChunk::blockChange_t* changes, size_t count);
+
+            //Apply one block change at X,Y,Z (GAME_BLOCK_CHANGE)
+            bool setBlock(int32_t X, int8_t Y, int32_t Z,
+                uint8_t blockID, uint8_t metadata=0);
             
             //Map chunk flags at X/Z
             void setChunkFlags( int32_t X, int32_t Z, uint32_t setflags=0);
@@ -107,6 +156,57 @@ namespace mc__ {
                 uint8_t size_X=5, uint8_t size_Y=8, uint8_t size_Z=5,
                 uint8_t metadata=0);
             
+            //Save loaded map chunks in region containing block X,Z.  Chunks
+            // already in the region file and not loaded are kept.
+            bool saveRegion(int32_t X, int32_t Z);
+
+            //Save every region with loaded map chunks.  Returns regions saved.
+            size_t saveRegions();
+
+            //Load map chunks from region file containing block X,Z, except
+            // ones already loaded.  Returns number of chunks loaded.
+            size_t loadRegion(int32_t X, int32_t Z);
+
+            //Load map chunk at X,Z from its region file (false if not saved)
+            bool loadChunk(int32_t X, int32_t Z);
+
+            //Load map chunk at X,Z from its region file on the loader
+            // thread (false if already loaded)
+            bool requestChunk(int32_t X, int32_t Z);
+
+            //Add up to max chunks finished by the loader to the map
+            //  Returns number of chunks added.
+            size_t applyLoads(size_t max=8);
+
+            //Unlink map chunk at X,Z from its neighbors, call the evict
+            // handler, and delete it (false if not found)
+            bool removeMapChunk(int32_t X, int32_t Z);
+
+            //Bytes used by map chunks (0 = no limit).  When it is more than
+            // the budget, evictChunks removes the map chunks farthest from
+            // block X,Z until it fits.  Returns number of chunks removed.
+            void setMemoryBudget(size_t bytes) { memoryBudget = bytes; };
+            size_t evictChunks(double X, double Z);
+
+            //Compress map chunks farther than distance blocks from X,Z and
+            // unused for seconds.  They are uncompressed again when needed.
+            //  Returns number of chunks compressed.
+            size_t freezeIdle(double X, double Z, double distance,
+                double seconds);
+
+            //Bytes used by all map chunks, by component
+            mc__::MapChunk::memory_t getMemory() const;
+
+            //Read-only view of all map chunks for other threads.  Shares
+            // block arrays (cold map chunks are copied compressed), and
+            // does not include chunkUpdates not yet added to the map.
+            std::shared_ptr<const mc__::Snapshot> takeSnapshot();
+
+            //Handler to free resources of map chunks before deletion
+            void setEvictHandler(evictHandler_t handler) {
+                evictHandler = handler;
+            };
+
             //Check key for coordinates
             uint64_t getKey(const int32_t X, const int32_t Z) const;
             
@@ -124,6 +224,16 @@ namespace mc__ {
             
             //Name for this world
             std::string name;
+
+            //Directory of region files
+            std::string regionPath;
+
+            //Loads map chunks from region files in regionPath, nearest to
+            // its center first
+            mc__::ChunkLoader loader;
+
+            //Removed map chunks wait here for readers on other threads
+            mc__::Epoch epoch;
             
             //TODO: list of warp points?
             
@@ -136,6 +246,54 @@ namespace mc__ {
             mc__::Chunk* makeFlatGrass(uint8_t size_X, uint8_t size_Y,
                 uint8_t size_Z, int32_t x, int8_t y, int32_t z);
 
+            //Memory limit for map chunks, handler for evicted chunks
+            size_t memoryBudget;
+            evictHandler_t evictHandler;
+
+            //Generation of last snapshot
+            uint64_t snapshotGeneration;
+
+            //Same map chunks as coordMapChunks, for findChunk
+            mc__::ChunkMap chunkMap;
+
+            //Threads for redraw, started by the first one
+            std::unique_ptr<mc__::ThreadPool> redrawPool;
+
+            //Mini-chunk in chunkUpdates not yet applied to the map
+            typedef struct {
+                mc__::Chunk *chunk;
+                uint64_t sequence;  //arrival order
+                double arrived;     //MapChunk::now()
+                double distance;    //squared, from focus to map chunk center
+            } pendingChunk_t;
+
+            //Pending mini-chunks, farthest first when pendingSorted, so the
+            // nearest one is at the back
+            std::vector<pendingChunk_t> pendingChunks;
+            uint64_t pendingSequence;
+            bool pendingSorted;
+            int32_t pendingFocus_X, pendingFocus_Z;
+
+            //Add one mini-chunk to the map, delete it if cleanup
+            void applyChunkUpdate(mc__::Chunk *chunk, bool cleanup);
+
+            //Unlink neighbors, call evict handler, retire map chunk to epoch
+            void deleteMapChunk(mc__::MapChunk* mapchunk);
+
+            //Region files opened for reading
+            XZRegion_t regions;
+
+            //Mapped region file containing block X,Z (NULL if none)
+            mc__::Region* getRegion(int32_t X, int32_t Z);
+            void closeRegion(int32_t X, int32_t Z);
+
+            //Region file name for block X,Z
+            std::string getRegionFile(int32_t X, int32_t Z) const;
+
+            //Add compressed map chunk at X,Z to map
+            bool addMapChunkZip(int32_t X, int32_t Z,
+                const uint8_t* data, uint32_t length);
+
     };
 
 }
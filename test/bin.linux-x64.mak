@@ -23,6 +23,10 @@ RM=rm -f
 # LOGFILES      names of log files to clean up with make clean
 # DEBUG         "on" to turn on debugging
 # MOREFLAGS     Add custom flags to object compile phase
+# STRESS_SRC    .cpp files of stress tests, one program each ("make stress")
+# CHECK_SRC     .cpp files of checks, built and run by "make check"
+# BENCH_SRC     .cpp files of benchmarks ("make bench")
+# TOOL_LIBS     -L and -l for the programs above
 
 #No LDFLAGS needed for Linux
 LDFLAGS=
@@ -37,6 +41,13 @@ SRC=$(addprefix $(SRCDIR)/, $(SRCFILES))
 OBJFILES=$(SRCFILES:.cpp=.o)
 OBJ=$(addprefix $(BUILD)/, $(OBJFILES))
 BBIN=$(addprefix bin/, $(BIN))
+EXE=
+STRESS_BBIN=$(addprefix bin/, $(STRESS_SRC:.cpp=$(EXE)))
+CHECK_BBIN=$(addprefix bin/, $(CHECK_SRC:.cpp=$(EXE)))
+BENCH_BBIN=$(addprefix bin/, $(BENCH_SRC:.cpp=$(EXE)))
+TOOL_SRC=$(STRESS_SRC) $(CHECK_SRC) $(BENCH_SRC)
+TOOL_OBJ=$(addprefix $(BUILD)/, $(TOOL_SRC:.cpp=.o))
+TOOL_BBIN=$(STRESS_BBIN) $(CHECK_BBIN) $(BENCH_BBIN)
 
 # Debug, or optimize
 ifeq ($(DEBUG),on)
@@ -63,6 +74,16 @@ $(BUILD)/%.o: $(SRCDIR)/%.cpp
 $(BBIN): $(OBJ)
 	$(CC) $^ $(CFLAGS) $(LDFLAGS) $(LIBS) -o $@
 
+# Build stress tests, checks and benchmarks, only need libmc--c and its
+# core dependencies.  Checks exit with 1 on failure.
+stress: $(BUILD) $(STRESS_BBIN)
+bench: $(BUILD) $(BENCH_BBIN)
+check: $(BUILD) $(CHECK_BBIN)
+	@for t in $(CHECK_BBIN); do echo $$t; ./$$t || exit 1; done
+
+$(TOOL_BBIN): bin/%$(EXE): $(BUILD)/%.o
+	$(CC) $< $(CFLAGS) $(LDFLAGS) $(TOOL_LIBS) -o $@
+
 #Build again, don't care why
 rebuild: 
 	$(CC) $(OBJ) $(CFLAGS) $(LDFLAGS) $(LIBS) -o $(BBIN)
@@ -81,4 +102,4 @@ uninstall:
 # Remove object files and core files with "clean" (- prevents errors from exiting)
 .clean: clean
 clean:
-	-$(RM) $(BBIN) $(OBJ) core $(LOGFILES)
+	-$(RM) $(BBIN) $(OBJ) $(TOOL_BBIN) $(TOOL_OBJ) core $(LOGFILES)
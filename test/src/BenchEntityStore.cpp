@@ -0,0 +1,209 @@
+/*
+  libmc--c BenchEntityStore
+  Relative move updates per second: entity objects in a map, Mobiles, and
+  EntityStore directly.  Proximity queries: grid vs. linear scan.
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+
+//STL
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//mc--
+#include <mc--/Mobiles.hpp>
+using mc__::World;
+using mc__::Mobiles;
+using mc__::Entity;
+using mc__::EntityStore;
+
+typedef std::chrono::steady_clock benchClock;
+
+//Seconds since start
+static double since(benchClock::time_point start)
+{
+    return std::chrono::duration<double>(benchClock::now() - start).count();
+}
+
+//Relative moves of random entities: as entity objects in a map (before
+// EntityStore), through Mobiles one at a time and a tick at a time, and on
+// the store directly
+static void benchMoves(size_t entities, size_t moves)
+{
+    World world;
+    Mobiles mobiles(world);
+    std::unordered_map<uint32_t, Entity*> objects;
+    for (size_t i = 0; i < entities; i++) {
+        uint32_t eid = 1000 + i*7;
+        mobiles.addEntity(eid, 90, i*32, 64*32, i*16);
+        objects[eid] = new Entity(eid, i, 64, i/2.0);
+    }
+
+    std::mt19937 rng(1);
+    std::vector<uint32_t> eids(moves);
+    for (size_t i = 0; i < moves; i++) {
+        eids[i] = 1000 + (rng() % entities)*7;
+    }
+
+    benchClock::time_point start = benchClock::now();
+    for (size_t i = 0; i < moves; i++) {
+        objects.find(eids[i])->second->move(1, -1, 1);
+    }
+    double mapSeconds = since(start);
+
+    start = benchClock::now();
+    for (size_t i = 0; i < moves; i++) {
+        mobiles.moveEntity(eids[i], 1, -1, 1);
+    }
+    double mobilesSeconds = since(start);
+
+    //One network tick of moves at a time, as Mobiles::moveEntities does
+    std::vector<EntityStore::move_t> tick(64);
+    start = benchClock::now();
+    for (size_t i = 0; i + tick.size() <= moves; i += tick.size()) {
+        for (size_t j = 0; j < tick.size(); j++) {
+            EntityStore::move_t& m = tick[j];
+            m.eid = eids[i + j];
+            m.dX = 1; m.dY = -1; m.dZ = 1;
+            m.dYaw = 0; m.dPitch = 0;
+        }
+        mobiles.moveEntities(&tick[0], tick.size());
+    }
+    double tickSeconds = since(start);
+
+    start = benchClock::now();
+    double seconds = EntityStore::now();
+    for (size_t i = 0; i < moves; i++) {
+        mobiles.store.move(mobiles.store.find(eids[i]), 1, -1, 1, seconds);
+    }
+    double storeSeconds = since(start);
+
+    //Read every X position, 200 times
+    int64_t sum = 0;
+    start = benchClock::now();
+    for (int k = 0; k < 200; k++) {
+        std::unordered_map<uint32_t, Entity*>::const_iterator iter;
+        for (iter = objects.begin(); iter != objects.end(); iter++) {
+            sum += iter->second->X;
+        }
+    }
+    double mapIterate = since(start);
+    start = benchClock::now();
+    for (int k = 0; k < 200; k++) {
+        for (size_t slot = 0; slot < mobiles.store.slots(); slot++) {
+            sum += mobiles.store.X[slot];
+        }
+    }
+    double storeIterate = since(start);
+
+    cout << entities << " entities, " << moves << " random relative moves"
+         << std::fixed << std::setprecision(1) << endl
+         << "  map lookup + Entity::move    " << moves/mapSeconds/1e6
+         << "M moves/s" << endl
+         << "  Mobiles::moveEntity (store)  " << moves/mobilesSeconds/1e6
+         << "M moves/s" << endl
+         << "  Mobiles::moveEntities (64)   " << moves/tickSeconds/1e6
+         << "M moves/s" << endl
+         << "  EntityStore::find + move     " << moves/storeSeconds/1e6
+         << "M moves/s" << endl
+         << std::setprecision(2)
+         << "  iterate X positions: map " << mapIterate*1e9/(200.0*entities)
+         << " ns/entity, store " << storeIterate*1e9/(200.0*entities)
+         << " ns/entity" << (sum == 0 ? " " : "") << endl;
+
+    std::unordered_map<uint32_t, Entity*>::iterator iter;
+    for (iter = objects.begin(); iter != objects.end(); iter++) {
+        delete iter->second;
+    }
+}
+
+//Radius queries with the grid (findInRadius) and by checking every slot,
+// entities spread over 1024x128x1024 blocks
+static bool benchRadius(size_t entities, size_t queries, double radius)
+{
+    EntityStore store;
+    std::mt19937 rng(2);
+    for (size_t i = 0; i < entities; i++) {
+        store.add(i + 1, EntityStore::KIND_ENTITY, 90, NULL,
+            (int32_t)(rng() % 32768) - 16384, rng() % 4096,
+            (int32_t)(rng() % 32768) - 16384, 0, 0);
+    }
+
+    std::vector<double> qX(queries), qZ(queries);
+    for (size_t q = 0; q < queries; q++) {
+        qX[q] = (int32_t)(rng() % 1024) - 512;
+        qZ[q] = (int32_t)(rng() % 1024) - 512;
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(entities);
+    size_t gridFound = 0, scanFound = 0;
+    benchClock::time_point start = benchClock::now();
+    for (size_t q = 0; q < queries; q++) {
+        result.clear();
+        gridFound += store.findInRadius(qX[q], 64, qZ[q], radius, result);
+    }
+    double gridSeconds = since(start);
+
+    start = benchClock::now();
+    double r2 = radius*radius;
+    for (size_t q = 0; q < queries; q++) {
+        result.clear();
+        for (uint32_t slot = 0; slot < store.slots(); slot++) {
+            double dx = store.abs_X[slot] - qX[q];
+            double dy = store.abs_Y[slot] - 64;
+            double dz = store.abs_Z[slot] - qZ[q];
+            if (dx*dx + dy*dy + dz*dz <= r2) {
+                result.push_back(slot);
+            }
+        }
+        scanFound += result.size();
+    }
+    double scanSeconds = since(start);
+
+    cout << entities << " entities, " << queries << " queries of radius "
+         << std::setprecision(0) << radius << std::setprecision(2) << endl
+         << "  grid " << gridSeconds*1e6/queries << " us/query, linear scan "
+         << scanSeconds*1e6/queries << " us/query (found " << gridFound
+         << "/" << scanFound << ")" << endl;
+
+    return (gridFound == scanFound);
+}
+
+int main(int argc, char** argv)
+{
+    size_t moves = (argc > 1 ? (size_t)atol(argv[1]) : 5000000);
+
+    benchMoves(20000, moves);
+
+    bool same = benchRadius(10000, 2000, 32);
+    same &= benchRadius(100000, 2000, 32);
+    if (!same) {
+        cerr << "BenchEntityStore: grid and linear scan differ" << endl;
+        return 1;
+    }
+    return 0;
+}
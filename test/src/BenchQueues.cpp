@@ -0,0 +1,179 @@
+/*
+  libmc--c BenchQueues
+  Cross-thread event throughput: SPSCQueue, MPSCQueue and a mutex guarded
+  std::deque, with producer threads pushing and one consumer draining.
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+
+//STL
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//mc--
+#include <mc--/Events.hpp>
+#include <mc--/EventQueue.hpp>
+using mc__::Events;
+using mc__::SPSCQueue;
+using mc__::MPSCQueue;
+
+typedef Events::Event_t event_t;
+
+//Events drained at a time, and queue capacity
+static const size_t bench_BATCH = 256;
+static const size_t bench_CAPACITY = 4096;
+
+//What the queues were before: a mutex and a std::deque
+class LockedQueue {
+    public:
+        bool push(const event_t& event) {
+            std::lock_guard<std::mutex> guard(lock);
+            events.push_back(event);
+            return true;
+        };
+        size_t drain(event_t* out, size_t max) {
+            std::lock_guard<std::mutex> guard(lock);
+            size_t count = 0;
+            while (count < max && !events.empty()) {
+                out[count++] = events.front();
+                events.pop_front();
+            }
+            return count;
+        };
+    protected:
+        std::mutex lock;
+        std::deque<event_t> events;
+};
+
+//Push events numbered first, first + step, ... below total
+template <typename Q>
+static void produce(Q& queue, size_t first, size_t step, size_t total)
+{
+    event_t event;
+    event.type = Events::GAME_ENT_REL_MOVE;
+    event.hasPayload = false;
+    for (size_t i = first; i < total; i += step) {
+        event.data = (const void*)i;
+        while (!queue.push(event)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+//Events per second (millions) through queue with producers threads.
+//  With one producer, events must come out in order (ordered is false if
+//  they did not).
+template <typename Q>
+static double run(Q& queue, size_t producers, size_t total, bool& ordered)
+{
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.push_back(std::thread(produce<Q>, std::ref(queue), p,
+            producers, total));
+    }
+
+    event_t batch[bench_BATCH];
+    size_t taken = 0, next = 0;
+    ordered = true;
+    while (taken < total) {
+        size_t count = queue.drain(batch, bench_BATCH);
+        if (count == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (producers == 1) {
+            for (size_t i = 0; i < count; i++) {
+                if ((size_t)batch[i].data != next++) {
+                    ordered = false;
+                }
+            }
+        }
+        taken += count;
+    }
+
+    for (size_t p = 0; p < threads.size(); p++) {
+        threads[p].join();
+    }
+
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return total/seconds/1e6;
+}
+
+//Print one result line
+static void report(const char* name, double rate, bool ordered)
+{
+    cout << std::left << std::setw(28) << name << std::right
+         << std::fixed << std::setprecision(1) << std::setw(8) << rate
+         << "M events/s" << (ordered ? "" : "  OUT OF ORDER") << endl;
+}
+
+int main(int argc, char** argv)
+{
+    size_t total = (argc > 1 ? (size_t)atol(argv[1]) : 20000000);
+    bool ordered, allOrdered = true;
+
+    cout << total << " events, drained " << bench_BATCH << " at a time, "
+         << std::thread::hardware_concurrency() << " cores" << endl;
+    {
+        SPSCQueue<event_t> queue(bench_CAPACITY);
+        double rate = run(queue, 1, total, ordered);
+        report("SPSCQueue 1 producer", rate, ordered);
+        allOrdered &= ordered;
+    }
+    {
+        MPSCQueue<event_t> queue(bench_CAPACITY);
+        double rate = run(queue, 1, total, ordered);
+        report("MPSCQueue 1 producer", rate, ordered);
+        allOrdered &= ordered;
+    }
+    {
+        MPSCQueue<event_t> queue(bench_CAPACITY);
+        double rate = run(queue, 4, total, ordered);
+        report("MPSCQueue 4 producers", rate, true);
+    }
+    {
+        LockedQueue queue;
+        double rate = run(queue, 1, total, ordered);
+        report("mutex + std::deque 1 prod", rate, ordered);
+        allOrdered &= ordered;
+    }
+    {
+        LockedQueue queue;
+        double rate = run(queue, 4, total, ordered);
+        report("mutex + std::deque 4 prod", rate, true);
+    }
+
+    if (!allOrdered) {
+        cerr << "BenchQueues: events out of order" << endl;
+        return 1;
+    }
+    return 0;
+}
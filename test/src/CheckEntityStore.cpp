@@ -0,0 +1,108 @@
+/*
+  libmc--c CheckEntityStore
+  Checks of EntityStore snapshots and interpolation, exits with 1 if one
+  fails.
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+
+//STL
+#include <cmath>
+#include <iostream>
+#include <random>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//mc--
+#include <mc--/EntityStore.hpp>
+using mc__::EntityStore;
+
+//Checks failed
+static unsigned failed = 0;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        cerr << "FAILED: " << what << endl;
+        failed++;
+    }
+}
+
+//Ticks arriving 45-55 ms apart each get their own snapshot, and packets of
+// one tick (same time) share one
+static void checkJitteredTicks()
+{
+    EntityStore store;
+    store.setInterpolation(0.1, 0.25, 0.05);
+    uint32_t slot = store.add(1, EntityStore::KIND_ENTITY, 0, NULL,
+        0, 64*32, 0, 0, 0);
+
+    std::mt19937 rng(7);
+    double seconds = EntityStore::now() + 1.0;
+    for (int tick = 0; tick < 200; tick++) {
+        seconds += 0.045 + (rng() % 11)*0.001;
+        double last = store.snapshotTime(slot);
+
+        //Move and look of one tick, stamped once
+        store.move(slot, 32, 0, 0, seconds);
+        store.look(slot, 4, 0, seconds);
+        store.move(slot, 0, 0, 16, seconds);
+
+        check(store.snapshotTime(slot) == seconds && last < seconds,
+            "tick 45-55 ms after the last one got its own snapshot");
+    }
+    check(store.snapshots(slot) == EntityStore::snap_MAX,
+        "snapshot ring is full");
+}
+
+//Extrapolated velocity is one tick of motion per tick interval
+static void checkExtrapolation()
+{
+    EntityStore store;
+    store.setInterpolation(0, 0.25, 0.05);
+    uint32_t slot = store.add(1, EntityStore::KIND_ENTITY, 0, NULL,
+        0, 64*32, 0, 0, 0);
+
+    //One block per tick, ticks 48 and 52 ms apart
+    double seconds = EntityStore::now() + 1.0;
+    double gaps[4] = { 0.052, 0.048, 0.052, 0.048 };
+    for (int tick = 0; tick < 4; tick++) {
+        seconds += gaps[tick];
+        store.move(slot, 32, 0, 0, seconds);
+    }
+
+    //24 ms past the newest snapshot: half a block past it
+    store.interpolate(seconds + 0.024);
+    double expected = 4.0 + 0.024/0.05;
+    check(fabs(store.draw_X[slot] - expected) < 0.01,
+        "extrapolation moves one block per tick");
+}
+
+int main()
+{
+    checkJitteredTicks();
+    checkExtrapolation();
+
+    if (failed != 0) {
+        cerr << failed << " EntityStore checks failed" << endl;
+        return 1;
+    }
+    cout << "EntityStore checks passed" << endl;
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+  libmc--c StressChunkMap
+  Readers find map chunks while a writer adds, removes and evicts them.
+  Build with -fsanitize=thread or -fsanitize=address to check the
+  Epoch/ChunkMap lock free lookups after changes.
+
+  Copyright 2011 axus
+
+    libmc--c is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as
+    published by the Free Software Foundation, either version 3 of the
+    License, or at your option) any later version.
+
+    libmc--c is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this program.  If not, see
+    <http://www.gnu.org/licenses/>.
+*/
+
+
+//STL
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+//mc--
+#include <mc--/World.hpp>
+using mc__::World;
+using mc__::Chunk;
+using mc__::MapChunk;
+using mc__::Epoch;
+
+//Map chunks are added in a square of (2*stress_RADIUS + 1)^2
+static const int32_t stress_RADIUS = 12;
+
+//Reader threads
+static const size_t stress_READERS = 3;
+
+typedef std::chrono::steady_clock stressClock;
+
+//Counted by readers
+struct stressCount_t {
+    std::atomic<uint64_t> lookups;
+    std::atomic<uint64_t> found;
+    std::atomic<uint64_t> neighbors;
+    std::atomic<uint64_t> bad;
+};
+
+//Random map chunk coordinate in the square
+static int32_t randomCoord(std::mt19937& rng)
+{
+    return ((int32_t)(rng() % (2*stress_RADIUS + 1)) - stress_RADIUS) << 4;
+}
+
+//Find random map chunks and read their neighbors until stop
+static void reader(World& world, std::atomic<bool>& stop,
+    stressCount_t& count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    while (!stop.load()) {
+        int32_t X = randomCoord(rng), Z = randomCoord(rng);
+
+        Epoch::Guard guard(world.epoch);
+        MapChunk *mapchunk = world.findChunk(X, Z);
+        count.lookups++;
+        if (mapchunk == NULL) {
+            continue;
+        }
+        count.found++;
+
+        //Wrong map chunk, or one already deleted
+        if (mapchunk->X != X || mapchunk->Z != Z) {
+            count.bad++;
+        }
+
+        for (uint8_t i = 0; i < 6; i++) {
+            MapChunk *neighbor = mapchunk->neighbors[i].load();
+            if (neighbor != NULL) {
+                count.neighbors++;
+                if ((neighbor->X & 0xF) != 0 || (neighbor->Z & 0xF) != 0) {
+                    count.bad++;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = (argc > 1 ? atof(argv[1]) : 3.0);
+
+    World world;
+    //Small enough that the writer's evictChunks removes map chunks
+    world.setMemoryBudget(64*1024*1024);
+
+    std::atomic<bool> stop(false);
+    stressCount_t count;
+    count.lookups = count.found = count.neighbors = count.bad = 0;
+
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < stress_READERS; i++) {
+        readers.push_back(std::thread(reader, std::ref(world),
+            std::ref(stop), std::ref(count), (uint32_t)(i + 1)));
+    }
+
+    //Writer: add, remove and evict at random
+    std::mt19937 rng(99);
+    uint64_t inserts = 0, removes = 0, evicts = 0;
+    stressClock::time_point start = stressClock::now();
+    while (std::chrono::duration<double>(stressClock::now() - start).count()
+        < seconds)
+    {
+        int32_t X = randomCoord(rng), Z = randomCoord(rng);
+        switch (rng() % 8) {
+            case 0:
+                evicts += world.evictChunks(X, Z);
+                break;
+            case 1: case 2: case 3:
+                if (world.removeMapChunk(X, Z)) {
+                    removes++;
+                }
+                break;
+            default: {
+                Chunk chunk(0, 0, 0, X, 0, Z);
+                chunk.block_array[0].blockID = 1;
+                world.addMapChunk(&chunk);
+                inserts++;
+                break;
+            }
+        }
+    }
+
+    stop = true;
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i].join();
+    }
+
+    //No guards left, everything retired must be freed
+    world.epoch.reclaim();
+    size_t pending = world.epoch.pending();
+
+    cout << "inserts " << inserts << " removes " << removes
+         << " evicted " << evicts << endl
+         << "lookups " << count.lookups.load() << " found "
+         << count.found.load() << " neighbor reads "
+         << count.neighbors.load() << endl
+         << "bad " << count.bad.load() << " pending " << pending << endl;
+
+    if (count.bad.load() != 0 || pending != 0) {
+        cerr << "StressChunkMap failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -102,6 +102,13 @@ UserInterface::UserInterface(
     //Load textures   //TODO: configurable
     viewer.init(texture_files, true);
 
+    //Compile models of commonly dropped items over the first frames
+    const uint16_t commonItems[] = { Blk::Dirt, Blk::Cobble, Blk::Sand,
+        Blk::Gravel, Blk::Log, Blk::Wood, Blk::Sapling, 295 /*Seeds*/,
+        262 /*Arrow*/, 287 /*String*/, 288 /*Feather*/, 352 /*Bone*/ };
+    viewer.prewarmItemModels(std::vector<uint16_t>(commonItems,
+        commonItems + sizeof(commonItems)/sizeof(commonItems[0])));
+
     //Reset camera
     resetCamera();
 
@@ -184,12 +191,29 @@ bool UserInterface::run()
     
     //Clear the view
     viewer.clear();
+    viewer.startFrame();
     
     //Redraw the entities, items, etc.
+    mobiles.interpolate();
     viewer.drawMobiles(mobiles);
     
+    //Add chunks from server nearest to camera first, for up to 4 ms
+    world.updateMapChunks(viewer.cam_X/texmap_TILE_LENGTH,
+        viewer.cam_Z/texmap_TILE_LENGTH, 4);
+
+    //Add chunks loaded from region files, nearest to camera first
+    world.loader.setCenter(viewer.cam_X/texmap_TILE_LENGTH,
+        viewer.cam_Z/texmap_TILE_LENGTH);
+    world.applyLoads();
+
+    //Free far away chunks if over memory budget, compress idle ones
+    world.evictChunks(viewer.cam_X/texmap_TILE_LENGTH,
+        viewer.cam_Z/texmap_TILE_LENGTH);
+    world.freezeIdle(viewer.cam_X/texmap_TILE_LENGTH,
+        viewer.cam_Z/texmap_TILE_LENGTH, 128, 30);
+
     //Redraw the world (terrain)
-    viewer.drawWorld(world);    
+    viewer.drawWorld(world);
     
     //2D overlay
     //Update status display
@@ -218,6 +242,7 @@ bool UserInterface::run()
     }
     
     //Update the window
+    viewer.endFrame();
     App.display();
 
     return Running;
@@ -259,7 +284,7 @@ bool UserInterface::actions()
     
     //Process all events
     Events::Event_t event;
-    while ( !events.isEmpty && events.get(event) ) {
+    while ( events.get(event) ) {
         switch( event.type ) {
             case Events::GAME_CHAT_MESSAGE:
                 //TODO: draw chat message to screen
@@ -580,6 +605,16 @@ bool UserInterface::handleKeys()
                 viewer.saveLocalBlocks(world);
                 cout << "Wrote nearby block info to local_blocks.txt" << endl;
                 break;
+            //Write render statistics of recent frames
+            case sf::Keyboard::Key::F6:
+                viewer.saveStatsCSV("render_stats.csv");
+                cout << "Wrote render statistics to render_stats.csv" << endl;
+                break;
+            //Save loaded chunks to region files
+            case sf::Keyboard::Key::F7:
+                cout << "Saved " << world.saveRegions() << " region files"
+                    << endl;
+                break;
             //Redraw everything
             case sf::Keyboard::Key::F5:
                 cout << "Recalculating visibility of all chunks" << endl;
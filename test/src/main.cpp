@@ -699,6 +699,7 @@ int main(int argc, char** argv)
 
     //Game world
     World world;
+    world.setMemoryBudget(256 << 20);   //256 MB of map chunks
 
     //Game events
     Events events;